@@ -2,10 +2,19 @@
 
 // Experiment 2
 #include "PL0/Core/Token.hpp"
+#include "PL0/Core/TokenBuffer.hpp"
 #include "PL0/Core/Lexer.hpp"
+#include "PL0/Core/TokenCache.hpp"
 
 // Experiment 3
+#include "PL0/Core/Ast.hpp"
+#include "PL0/Core/Grammar.hpp"
 #include "PL0/Core/LL1Parser.hpp"
+#include "PL0/Core/ParserGenerator.hpp"
+#include "PL0/Core/PrattParser.hpp"
+#include "PL0/Core/PredictionTable.hpp"
+#include "PL0/Core/RecursiveDescentParser.hpp"
+#include "PL0/Core/StaticTable.hpp"
 
 // Experiment 4
 #include "PL0/Core/SemanticLL1Parser.hpp"
@@ -13,6 +22,13 @@
 // Experiment 6
 #include "PL0/Core/Optimizer.hpp"
 
+#include "PL0/Utils/Arena.hpp"
 #include "PL0/Utils/ArgParser.hpp"
+#include "PL0/Utils/Batch.hpp"
+#include "PL0/Utils/Interner.hpp"
+#include "PL0/Utils/OutputFile.hpp"
 #include "PL0/Utils/Reporter.hpp"
-#include "PL0/Utils/Scanner.hpp"
\ No newline at end of file
+#include "PL0/Utils/Scanner.hpp"
+#include "PL0/Utils/SimdScan.hpp"
+#include "PL0/Utils/SourceBuffer.hpp"
+#include "PL0/Utils/ThreadPool.hpp"
\ No newline at end of file
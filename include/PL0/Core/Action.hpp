@@ -1,5 +1,6 @@
 #pragma once
-#include <vector>
+#include <span>
+#include <string_view>
 
 namespace PL0
 {
@@ -10,13 +11,21 @@ namespace Action
 // Action functions
 //////////////////////
 
-int print(const std::vector<int>& operands);
-int assign(const std::vector<int>& operands);
-int opposite(const std::vector<int>& operands);
-int add(const std::vector<int>& operands);
-int sub(const std::vector<int>& operands);
-int mul(const std::vector<int>& operands);
-int div(const std::vector<int>& operands);
+int print(std::span<const int> operands);
+int assign(std::span<const int> operands);
+int opposite(std::span<const int> operands);
+int add(std::span<const int> operands);
+int sub(std::span<const int> operands);
+int mul(std::span<const int> operands);
+int div(std::span<const int> operands);
+
+using Function = int (*)(std::span<const int> operands);
+
+/**
+ * @return The action function of a name, e.g. "add" for add(), or nullptr if there is none.
+ * @note Grammar files bind their action symbols to the functions by these names.
+ */
+Function find(std::string_view name);
 }  // namespace Action
 
 }  // namespace PL0
\ No newline at end of file
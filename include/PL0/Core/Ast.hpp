@@ -0,0 +1,403 @@
+#pragma once
+#include "PL0/Utils/Arena.hpp"
+#include "PL0/Utils/SourceBuffer.hpp"
+#include "Token.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace PL0
+{
+using NodeId = uint32_t;  // The index of a node in its compilation unit.
+
+constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+
+/**
+ * @brief The kind of a node of the syntax tree. The operators are kinds of their own, so a node
+ *      needs no operator field.
+ * @note The children of each kind, in order:
+ *      - Program: Block
+ *      - Block: Const..., Var..., Procedure..., a statement
+ *      - Const: Ident, Number
+ *      - Procedure: Ident, Block
+ *      - Assign: Ident, an expression
+ *      - Call: Ident
+ *      - Begin: statements...
+ *      - If, While: a condition, a statement
+ *      - Read: Ident...
+ *      - Write: expressions...
+ *      - Odd, Neg: an expression
+ *      - Eql, Neq, Lss, Leq, Gtr, Geq, Add, Sub, Mul, Div: two expressions
+ *      Var, Ident, Number and Empty are leaves. Empty is the empty statement. Parentheses and
+ *      unary plus leave no node.
+ */
+enum class NodeKind : uint8_t
+{
+    // Declarations
+    Program,
+    Block,
+    Const,
+    Var,
+    Procedure,
+
+    // Statements
+    Assign,
+    Call,
+    Begin,
+    If,
+    While,
+    Read,
+    Write,
+    Empty,
+
+    // Conditions
+    Odd,
+    Eql,
+    Neq,
+    Lss,
+    Leq,
+    Gtr,
+    Geq,
+
+    // Expressions
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Neg,
+    Ident,
+    Number,
+};
+
+constexpr size_t NODE_KIND_COUNT = static_cast<size_t>(NodeKind::Number) + 1;
+
+constexpr std::array<std::string_view, NODE_KIND_COUNT> NODE_KIND_NAMES = {
+    "Program", "Block", "Const", "Var", "Procedure",
+    "Assign", "Call", "Begin", "If", "While", "Read", "Write", "Empty",
+    "Odd", "Eql", "Neq", "Lss", "Leq", "Gtr", "Geq",
+    "Add", "Sub", "Mul", "Div", "Neg", "Ident", "Number"};
+
+constexpr bool isLeaf(NodeKind kind)
+{
+    return kind == NodeKind::Var || kind == NodeKind::Ident || kind == NodeKind::Number ||
+           kind == NodeKind::Empty;
+}
+
+/**
+ * @note The payload of a leaf is its value: the ID of the identifier in the interner of the lexer,
+ *      or the value of the number. The payload of any other node is the ID of the first node of
+ *      its subtree (see CompilationUnit).
+ * @note The offset is the position of the first character of the token the node is built from,
+ *      e.g. the operator of a binary expression, in the source buffer.
+ */
+struct Node
+{
+    NodeKind kind;
+    uint32_t offset;
+    uint32_t payload;
+};
+
+static_assert(sizeof(Node) == 12);
+
+/**
+ * @brief The syntax tree of a parsed input.
+ * @note The nodes are allocated in an arena owned by the unit, and refer to each other by
+ *      32-bit indices. Nodes are never freed one by one: the whole tree is freed at once, in O(1),
+ *      when the unit is reset or destroyed.
+ * @note The nodes are in post-order: a node is added right after its last child, and the subtree
+ *      of a node is the range [first node, node]. So the last child of a node is the node before
+ *      it, and the previous sibling of a child is the node before its subtree. A node only
+ *      stores where its subtree begins, and building a tree only appends to the arena:
+ *          a * (b - c)  =>  0: a  1: b  2: c  3: Sub [1, 3]  4: Mul [0, 4]
+ */
+class CompilationUnit
+{
+public:
+    CompilationUnit() = default;
+
+    CompilationUnit(const CompilationUnit&) = delete;
+    CompilationUnit& operator=(const CompilationUnit&) = delete;
+
+public:
+    /**
+     * @brief Free the tree, and start a new one for the tokens of another source.
+     * @param source The source buffer the tokens are scanned from, if it is known.
+     */
+    void reset(std::shared_ptr<const SourceBuffer> source);
+
+    inline NodeId addLeaf(NodeKind kind, uint32_t offset, uint32_t value)
+    {
+        return m_nodes.push({kind, offset, value});
+    }
+
+    /**
+     * @param begin The first node of the subtree, i.e. the ID of the next node when the first child
+     *      began to be built. The children must have been added since.
+     */
+    inline NodeId addNode(NodeKind kind, uint32_t offset, NodeId begin)
+    {
+        return m_nodes.push({kind, offset, begin});
+    }
+
+    inline void setRoot(NodeId root)
+    {
+        m_root = root;
+    }
+
+public:
+    /**
+     * @return The root of the tree, or NO_NODE if no tree is built.
+     */
+    inline NodeId getRoot() const
+    {
+        return m_root;
+    }
+
+    inline const Node& getNode(NodeId id) const
+    {
+        return m_nodes[id];
+    }
+
+    /**
+     * @return The first node of the subtree of a node, which is the node itself for a leaf.
+     */
+    inline NodeId getBegin(NodeId id) const
+    {
+        const Node& node = m_nodes[id];
+        return isLeaf(node.kind) ? id : node.payload;
+    }
+
+    /**
+     * @return The last child of a node, or NO_NODE for a leaf.
+     */
+    inline NodeId getLastChild(NodeId id) const
+    {
+        return isLeaf(m_nodes[id].kind) ? NO_NODE : id - 1;
+    }
+
+    /**
+     * @return The previous sibling of a child of {parent}, or NO_NODE for the first child.
+     */
+    inline NodeId getPrevSibling(NodeId parent, NodeId child) const
+    {
+        NodeId begin = getBegin(child);
+        return begin > m_nodes[parent].payload ? begin - 1 : NO_NODE;
+    }
+
+    /**
+     * @brief Collect the children of a node in order.
+     */
+    void getChildren(NodeId id, std::vector<NodeId>& children) const;
+
+    /**
+     * @return The number of nodes, which is also the ID of the next node.
+     */
+    inline uint32_t getNodeCount() const
+    {
+        return m_nodes.size();
+    }
+
+    inline size_t getMemoryUsage() const
+    {
+        return m_nodes.getMemoryUsage();
+    }
+
+    inline const std::shared_ptr<const SourceBuffer>& getSource() const
+    {
+        return m_source;
+    }
+
+    /**
+     * @brief Print the tree, one node per line, indented by the depth.
+     * @note Identifiers are spelled as in the source, or as #ID if the source is unknown.
+     */
+    void print(std::ostream& os) const;
+
+private:
+    /**
+     * @brief Print the line of a node, without its children.
+     */
+    void printNode(std::ostream& os, NodeId id, size_t depth) const;
+
+private:
+    Arena<Node> m_nodes;
+    NodeId m_root = NO_NODE;
+    std::shared_ptr<const SourceBuffer> m_source;
+};
+
+/**
+ * @brief Build the tree of an arithmetic expression from its tokens, by the precedence of the
+ *      operators.
+ * @note The table-driven parsers have no rule to build the tree by, so they feed the builder
+ *      with the terminals they match. A leading minus applies to what the grammar of the parser
+ *      negates (see SignScope).
+ * @note The tokens are taken as the grammar of expressions takes them, so keywords are
+ *      identifiers, whose value is 0 since they are not interned.
+ * @note The tokens are in the order of their leaves, and each operator is added once its
+ *      operands are, so the nodes are in post-order as the unit needs them.
+ * @note The operator stack is kept between expressions, so a builder allocates nothing per token
+ *      once it has grown.
+ */
+class ExpressionBuilder
+{
+public:
+    /**
+     * @brief What the minus at the beginning of an expression applies to.
+     */
+    enum class SignScope : uint8_t
+    {
+        Term,        // The first term, as in LL1Parser: "-a + b" is Add(Neg(a), b).
+        Expression,  // The whole expression, as in SemanticLL1Parser (E -> - E' {2}):
+                     // "-a + b" is Neg(Add(a, b)), which is reduced at the end or at ")".
+    };
+
+    explicit ExpressionBuilder(CompilationUnit& unit, SignScope scope = SignScope::Term)
+        : m_unit(unit), m_signPrecedence(scope == SignScope::Term ? 3 : 1)
+    {
+    }
+
+    inline void push(const Token& token)
+    {
+        push(token.kind, token);
+    }
+
+    /**
+     * @return The root of the expression, or NO_NODE if the tokens do not make an expression,
+     *      e.g. the tokens of a grammar of another language. The builder is ready for the next
+     *      expression.
+     */
+    NodeId finish();
+
+private:
+    /**
+     * @note The first node of the subtree of an operator is known when the operator is pushed:
+     *      it is the first node of the left operand, which is complete by then, for a binary
+     *      operator, and the next node for a sign or an open parenthesis. So the operands need no
+     *      stack, but only a count to check the input.
+     */
+    struct Operator
+    {
+        NodeKind kind;
+        uint8_t precedence;  // 0 for (, 1 for a sign of an expression, 2 for + and -, 3 for a
+                             // sign of a term, 4 for * and /.
+        uint32_t offset;
+        NodeId begin;
+    };
+
+    /**
+     * @brief Push an invalid token, which the grammar of expressions takes by its first
+     *      character (see translateExpressionSymbol).
+     */
+    void pushInvalid(const Token& token);
+
+    /**
+     * @note One switch on the kind of the token dispatches every token, including keywords,
+     *      which the grammar of expressions takes as identifiers.
+     */
+    inline void push(TokenKind kind, const Token& token)
+    {
+        switch (kind) {
+        case TokenKind::Nul:
+            pushInvalid(token);
+            break;
+        case TokenKind::Ident:
+            pushOperand(NodeKind::Ident, token.offset, token.id);
+            break;
+        case TokenKind::Number:
+            pushOperand(NodeKind::Number, token.offset, static_cast<uint32_t>(token.number));
+            break;
+        case TokenKind::LParen:
+            expect(true);
+            m_operators.push_back({NodeKind::Empty, 0, token.offset, m_unit.getNodeCount()});
+            break;
+        case TokenKind::RParen:
+            expect(false);
+            reduce(1);  // Down to the open parenthesis
+            if (m_operators.empty()) {
+                m_valid = false;
+                break;
+            }
+            m_operators.pop_back();
+            break;
+        case TokenKind::Plus:
+        case TokenKind::Minus:
+            if (m_expectOperand) {  // A sign
+                if (kind == TokenKind::Minus) {
+                    m_operators.push_back(
+                        {NodeKind::Neg, m_signPrecedence, token.offset, m_unit.getNodeCount()});
+                }
+                break;
+            }
+            reduce(2);
+            pushBinary(kind == TokenKind::Plus ? NodeKind::Add : NodeKind::Sub, 2, token.offset);
+            break;
+        case TokenKind::Times:
+        case TokenKind::Slash:
+            expect(false);
+            reduce(4);
+            pushBinary(kind == TokenKind::Times ? NodeKind::Mul : NodeKind::Div, 4, token.offset);
+            break;
+        default:
+            if (kind >= TokenKind::Const) {  // A keyword
+                pushOperand(NodeKind::Ident, token.offset, token.id);
+            } else {
+                m_valid = false;
+            }
+            break;
+        }
+    }
+
+    inline void pushOperand(NodeKind kind, uint32_t offset, uint32_t value)
+    {
+        expect(true);
+        m_lastBegin = m_unit.addLeaf(kind, offset, value);
+        ++m_operandCount;
+        m_expectOperand = false;
+    }
+
+    inline void pushBinary(NodeKind kind, uint8_t precedence, uint32_t offset)
+    {
+        m_operators.push_back({kind, precedence, offset, m_lastBegin});
+        m_expectOperand = true;
+    }
+
+    inline void expect(bool operand)
+    {
+        if (m_expectOperand != operand) {
+            m_valid = false;
+        }
+    }
+
+    /**
+     * @brief Pop the operators of at least {precedence}, and build their nodes.
+     */
+    inline void reduce(uint8_t precedence)
+    {
+        while (!m_operators.empty() && m_operators.back().precedence >= precedence) {
+            const Operator& op = m_operators.back();
+            size_t arity = op.kind == NodeKind::Neg ? 1 : 2;
+            if (m_operandCount < arity) {
+                m_valid = false;
+                return;
+            }
+            m_operandCount -= arity - 1;
+            m_unit.addNode(op.kind, op.offset, op.begin);
+            m_lastBegin = op.begin;
+            m_operators.pop_back();
+        }
+    }
+
+private:
+    CompilationUnit& m_unit;
+    uint8_t m_signPrecedence;  // The precedence of a sign, by its scope.
+    std::vector<Operator> m_operators;
+    size_t m_operandCount = 0;  // The number of operands whose operators are not reduced yet.
+    NodeId m_lastBegin = 0;     // The first node of the subtree of the last node.
+    bool m_expectOperand = true;
+    bool m_valid = true;
+};
+}  // namespace PL0
@@ -0,0 +1,102 @@
+#pragma once
+#include "PredictionTable.hpp"
+#include "Rule.hpp"
+#include "Symbol.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace PL0
+{
+constexpr int NULL_OFFSET = -999999999;  // The value does not need to be passed.
+
+/**
+ * @brief A grammar with semantic actions, as written in a grammar file.
+ * @note A grammar file has one statement per line, whose words are separated by spaces:
+ *          // A comment runs to the end of the line.
+ *          %begin S                    The begin symbol, or the left-hand side of the first rule.
+ *          %action {6} add             Bind action {6} to Action::add (see Action::find).
+ *          T' -> * F {13} T' {14} @3   A rule, with actions and the index offset.
+ *             | / F {15} T' {16} @3    Another rule of the same left-hand side.
+ *             | ε {17} @0
+ *      A non-terminal begins with A-Z, and a terminal with anything else but a digit, '{', '@'
+ *      or '%'. ε stands for an empty right-hand side, and must be the only symbol of the rule.
+ * @note {n} is an action symbol, whose name begins with a digit. @n is the offset to locate the
+ *      action the value of the left-hand side is passed to (see SemanticLL1Parser), which must be
+ *      the last word of a rule. Every action must be bound to a function.
+ */
+struct Grammar
+{
+    Symbol beginSym;
+    std::vector<Rule> rules;        // The right-hand sides include the action symbols.
+    std::vector<int> indexOffsets;  // The index offset of each rule, or NULL_OFFSET.
+    std::vector<std::pair<Symbol, std::string>> actions;  // <action symbol, function name>
+
+    /**
+     * @brief Parse the text of a grammar file.
+     * @param text The text.
+     * @param name The name of the file in error messages.
+     * @throw std::runtime_error "<name>:<line>: <message>" if the text is not a valid grammar.
+     */
+    static Grammar parse(std::string_view text, std::string_view name = "<grammar>");
+
+    /**
+     * @brief Load a grammar file.
+     * @throw std::runtime_error If the file cannot be read, or is not a valid grammar.
+     */
+    static Grammar load(const std::string& path);
+};
+
+/**
+ * @brief The tables a parser runs on, which are calculated from a grammar.
+ * @note Calculating the tables takes the FIRST, FOLLOW and SELECT sets of the grammar, so they
+ *      can be cached in a binary file, from which they are loaded without any calculation.
+ *      A cache file records its format version, the byte order of the machine, and the size and
+ *      hash of the grammar file it was built from. It is rejected if any of them differs, or if
+ *      its checksum does not match.
+ */
+struct ParseTables
+{
+    PredictionTable predictionTable;  // The right-hand sides include the action symbols.
+    std::vector<int> indexOffsets;    // The index offset of each rule, or NULL_OFFSET.
+    std::vector<std::pair<Symbol, std::string>> actions;  // <action symbol, function name>
+
+    /**
+     * @brief Calculate the tables of a grammar.
+     * @throw std::runtime_error If the grammar is not LL(1).
+     */
+    static ParseTables build(const Grammar& grammar);
+
+    /**
+     * @brief Load the tables of a grammar file from its cache file, or calculate them and store
+     *      them in the cache file if it is missing or stale.
+     * @param grammarPath The grammar file.
+     * @param cachePath The cache file, or empty for "<grammarPath>.tables".
+     * @throw std::runtime_error If the grammar file cannot be read, or is not a valid grammar.
+     * @note Failing to store the cache file is ignored, since the cache is only an optimization.
+     */
+    static ParseTables load(const std::string& grammarPath,
+                            const std::filesystem::path& cachePath = {});
+
+    /**
+     * @brief Load the tables from a cache file.
+     * @param path The cache file.
+     * @param grammarText The text of the grammar file, which the cache must have been built from.
+     * @return The tables, or std::nullopt if there is no valid cache file.
+     */
+    static std::optional<ParseTables> loadCache(const std::filesystem::path& path,
+                                                std::string_view grammarText);
+
+    /**
+     * @brief Store the tables in a cache file.
+     * @param path The cache file.
+     * @param grammarText The text of the grammar file the tables are built from.
+     * @note The file is written to a temporary file and renamed, so a concurrent reader never
+     *      sees half a file. Failures are ignored.
+     */
+    void storeCache(const std::filesystem::path& path, std::string_view grammarText) const;
+};
+}  // namespace PL0
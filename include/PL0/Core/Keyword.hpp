@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace PL0
+{
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Keywords
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @note Keyword(i + 1) is the keyword KEYWORDS[i].
+ */
+enum class Keyword : uint8_t
+{
+    None = 0,  // Not a keyword.
+    Const,
+    Var,
+    Procedure,
+    Begin,
+    End,
+    If,
+    Then,
+    While,
+    Do,
+    Call,
+    Odd,
+    Write,
+    Read
+};
+
+constexpr std::array<std::string_view, 13> KEYWORDS = {
+    "const", "var", "procedure", "begin", "end", "if", "then",
+    "while", "do",  "call",      "odd",   "write", "read"};
+
+/**
+ * @return The (lowercase) spelling of the keyword, or an empty string for Keyword::None.
+ */
+constexpr std::string_view toString(Keyword keyword)
+{
+    if (keyword == Keyword::None) {
+        return {};
+    }
+    return KEYWORDS[static_cast<size_t>(keyword) - 1];
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Perfect hash of the keywords
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace KeywordHash
+{
+constexpr size_t MIN_LENGTH = 2;
+constexpr size_t MAX_LENGTH = 9;
+constexpr uint32_t TABLE_BITS = 5;
+constexpr size_t TABLE_SIZE = size_t(1) << TABLE_BITS;
+
+/**
+ * @brief Fold the case of an alphabet or a digit.
+ * @note Setting bit 5 maps A-Z to a-z and keeps a-z and 0-9 unchanged.
+ */
+constexpr char fold(char c)
+{
+    return static_cast<char>(c | 0x20);
+}
+
+/**
+ * @brief Hash a word by its length, its first two characters and its last character.
+ * @note The word must be an identifier of MIN_LENGTH~MAX_LENGTH characters.
+ *      The case of the characters is folded while hashing.
+ */
+constexpr uint32_t hash(std::string_view word, uint32_t seed)
+{
+    uint32_t h = seed ^ static_cast<uint32_t>(word.size());
+    for (char c : {word[0], word[1], word.back()}) {
+        h = (h ^ static_cast<unsigned char>(fold(c))) * 0x01000193u;  // FNV-1a step
+    }
+    return h >> (32 - TABLE_BITS);
+}
+
+/**
+ * @brief The smallest seed which maps all the keywords to different slots.
+ */
+constexpr uint32_t SEED = [] {
+    for (uint32_t seed = 0;; ++seed) {
+        std::array<bool, TABLE_SIZE> used{};
+        bool perfect = true;
+        for (std::string_view keyword : KEYWORDS) {
+            uint32_t slot = hash(keyword, seed);
+            perfect = perfect && !used[slot];
+            used[slot] = true;
+        }
+        if (perfect) {
+            return seed;
+        }
+    }
+}();
+
+/**
+ * @brief The keyword in each slot, or Keyword::None if the slot is empty.
+ */
+constexpr std::array<Keyword, TABLE_SIZE> TABLE = [] {
+    std::array<Keyword, TABLE_SIZE> table{};
+    for (size_t i = 0; i < KEYWORDS.size(); ++i) {
+        table[hash(KEYWORDS[i], SEED)] = static_cast<Keyword>(i + 1);
+    }
+    return table;
+}();
+}  // namespace KeywordHash
+
+/**
+ * @brief Find the keyword spelled by a word, ignoring case.
+ * @param word An identifier, i.e. an alphabet followed by alphabets and digits.
+ * @return The keyword, or Keyword::None if the word is an identifier.
+ * @note The word is hashed once and compared with at most one keyword.
+ */
+constexpr Keyword findKeyword(std::string_view word)
+{
+    if (word.size() < KeywordHash::MIN_LENGTH || word.size() > KeywordHash::MAX_LENGTH) {
+        return Keyword::None;
+    }
+
+    Keyword candidate = KeywordHash::TABLE[KeywordHash::hash(word, KeywordHash::SEED)];
+    std::string_view spelling = toString(candidate);
+    if (spelling.size() != word.size()) {
+        return Keyword::None;
+    }
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (KeywordHash::fold(word[i]) != spelling[i]) {
+            return Keyword::None;
+        }
+    }
+    return candidate;
+}
+
+static_assert([] {
+    for (size_t i = 0; i < KEYWORDS.size(); ++i) {
+        if (findKeyword(KEYWORDS[i]) != static_cast<Keyword>(i + 1)) {
+            return false;
+        }
+    }
+    return true;
+}());
+static_assert(findKeyword("procedure") == Keyword::Procedure);
+static_assert(findKeyword("BEGIN") == Keyword::Begin);
+static_assert(findKeyword("WhIlE") == Keyword::While);
+static_assert(findKeyword("d0") == Keyword::None);
+static_assert(findKeyword("reads") == Keyword::None);
+}  // namespace PL0
@@ -1,7 +1,11 @@
 #pragma once
+#include "Grammar.hpp"
 #include "Parser.hpp"
-#include "Rule.hpp"
+#include "PrattParser.hpp"
+#include "PredictionTable.hpp"
 #include "Symbol.hpp"
+#include <array>
+#include <optional>
 
 namespace PL0
 {
@@ -11,33 +15,65 @@ namespace PL0
 */
 class LL1Parser : public Parser
 {
+public:
     /**
-     * @note The prediction table for LL(1) parsing.
-     *     < left-hand side, <symbol in SELECT set, right-hand side> >
-    */
-    using PredictionTable = std::map<Symbol, std::map<Symbol, std::vector<Symbol>>>;
+     * @param engine The engine which parses the built-in grammar. PrattParser by default, which
+     *      gives the same results as the table-driven loop in fewer steps.
+     */
+    explicit LL1Parser(ExpressionEngine engine = ExpressionEngine::Pratt);
 
-public:
-    LL1Parser();
+    /**
+     * @brief Build the parser from the tables of a grammar, e.g. loaded from a grammar file.
+     * @throw std::runtime_error If the grammar has actions, which this parser cannot perform.
+     * @note The tables are always parsed by the table-driven loop.
+     */
+    explicit LL1Parser(const ParseTables& tables);
+
+    using Parser::parse;
 
     /**
-     * @brief Parse the given tokens.
-     * @param tokens The tokens to parse.
-     * @note Once there is a syntax error, the parsing process will stop immediately.
-    */
-    virtual void parse(const std::vector<Token>& tokens) override;
+     * @brief Parse the tokens pulled from a token source.
+     * @param tokens The token source.
+     * @note Once there is a syntax error, the parsing process will stop immediately, and the
+     *      remaining tokens will not be read.
+     */
+    virtual void parse(TokenSource& tokens) const override;
+
+    /**
+     * @brief Parse the tokens pulled from a token source, and build the tree of the expression.
+     * @param tokens The token source.
+     * @param unit The compilation unit to build the tree in, whose root is the expression.
+     * @note The tree is built from the terminals matched (see ExpressionBuilder).
+     */
+    virtual void parse(TokenSource& tokens, CompilationUnit& unit) const override;
 
 private:
-    void initSyntax();
-    void generatePredictionTable();
+    /**
+     * @brief Parse the tokens, and feed the terminals matched to {builder} if it is not null.
+     * @return Whether the input is correct.
+     */
+    bool analyze(TokenSource& tokens, ExpressionBuilder* builder) const;
 
 private:
-    void printPredictionTable();
-    void printState(const std::vector<Symbol>& analysisStack, const std::vector<Symbol>& inputStack);
+    /**
+     * @brief Look up the terminal of each token kind, once the prediction table is built.
+     */
+    void initKindSymbols();
+
+private:
+    void printPredictionTable() const;
+    void printState(const std::vector<SymbolId>& analysisStack, SymbolId lookahead) const;
 
 private:
-    RuleAnalyzer m_analyzer;
     PredictionTable m_predictionTable;
+
+    /**
+     * @brief The terminal of each token kind, or PredictionTable::NO_SYMBOL if the grammar does
+     *      not use it.
+     */
+    std::array<SymbolId, TOKEN_KIND_COUNT> m_kindSymbols;
+
+    std::optional<PrattParser> m_pratt;  // The engine of the built-in grammar, if it is used.
 };
 
 }  // namespace PL0
\ No newline at end of file
@@ -1,39 +1,221 @@
 #pragma once
 #include "PL0/Utils/Scanner.hpp"
 #include "Token.hpp"
+#include "TokenDocument.hpp"
 #include <memory>
 #include <vector>
 
 namespace PL0
 {
+/**
+ * @brief A token source that scans the tokens of a PL/0 source file on demand.
+ * @note Only one token is scanned per call of next(), so the tokens are never materialized as a
+ *      whole. Invalid tokens are reported as they are scanned.
+ * @note The values of the tokens are views into the source buffer, which stays alive as long as
+ *      the stream or a copy of getSource() is alive.
+ */
+class TokenStream : public TokenSource
+{
+public:
+    /**
+     * @param srcFile The path to the PL/0 source file.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one.
+     * @throw std::runtime_error If the file cannot be opened.
+     */
+    explicit TokenStream(const std::string& srcFile, std::shared_ptr<Interner> interner = nullptr);
+
+    /**
+     * @param buffer The source buffer to scan. Identifiers are converted to lowercase in it.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one.
+     */
+    explicit TokenStream(std::shared_ptr<SourceBuffer> buffer,
+                         std::shared_ptr<Interner> interner = nullptr);
+
+    bool next(Token& token) override;
+
+    /**
+     * @return The table which the IDs of the identifiers refer to.
+     */
+    inline const std::shared_ptr<Interner>& getInterner() const
+    {
+        return m_interner;
+    }
+
+private:
+    std::shared_ptr<SourceBuffer> m_buffer;  // The same buffer as getSource(), but writable.
+    const char* m_cur = nullptr;  // The first character after the last token scanned.
+    std::shared_ptr<Interner> m_interner;
+};
+
+/**
+ * @brief An edit of a PL/0 source file: {removed} bytes at {offset} are replaced by {inserted}.
+ */
+struct SourceEdit
+{
+    size_t offset;
+    size_t removed;
+    std::string inserted;
+};
+
+/**
+ * @brief The lexer of PL/0.
+ * @note A lexer only holds its settings, and each call interns the identifiers in the table it
+ *      is given (or in a new one), so a configured lexer can be shared by threads that lex at
+ *      the same time, like the parsers. The threads must not share a table, which is not
+ *      thread-safe (see Interner). tokenize() may still lex one file on several threads by
+ *      itself (see setThreadCount()).
+ */
 class Lexer
 {
 public:
-    Lexer() = default;
+    /**
+     * @brief The way the source code is split into tokens.
+     * @note Both modes produce the same tokens and the same diagnostics.
+     */
+    enum class Mode
+    {
+        Scanner,      // Character by character, through the Scanner.
+        TableDriven,  // A DFA driven by the character-class and state-transition tables.
+    };
+
+    Lexer(Mode mode = Mode::TableDriven) : m_mode(mode)
+    {
+    }
     ~Lexer() = default;
 
     /**
      * @brief Convert the PL/0 source code into a sequence of tokens.
      * @param srcFile The path to the PL/0 source file.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one. The
+     *      returned token list shares it (see TokenList::getInterner()).
      * @return The sequence of tokens.
-     * @note All the invalid identifiers will be reported.
+     * @note All the invalid tokens will be reported with their lines and columns.
+     * @note The source file stays in memory as long as the returned token list is alive, since
+     *      the values of the tokens are views into it.
+     * @note If a cache directory is set, the tokens may come from the cache (see
+     *      setCacheDirectory()). The values of cached identifiers are views into the interner,
+     *      and the identifiers keep their case in the source.
+     */
+    TokenList tokenize(const std::string& srcFile,
+                       std::shared_ptr<Interner> interner = nullptr) const;
+
+    /**
+     * @brief Convert the PL/0 source code held by a source buffer into a sequence of tokens.
+     * @param source The source buffer, e.g. SourceBuffer::fromText() for in-memory code.
+     *      Identifiers are converted to lowercase in it, unless the tokens come from the cache.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one.
+     * @return The sequence of tokens, which shares the ownership of the buffer.
+     * @note tokenize(srcFile) is the same as tokenize(std::make_shared<SourceBuffer>(srcFile)).
      */
-    std::vector<Token> tokenize(const std::string& srcFile);
+    TokenList tokenize(std::shared_ptr<SourceBuffer> source,
+                       std::shared_ptr<Interner> interner = nullptr) const;
+
+    /**
+     * @brief Scan the PL/0 source code lazily, one token at a time.
+     * @param srcFile The path to the PL/0 source file.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one (see
+     *      TokenStream::getInterner()).
+     * @return The stream of tokens.
+     * @note The stream always uses the table-driven DFA, whatever the mode of the lexer is.
+     */
+    TokenStream stream(const std::string& srcFile,
+                       std::shared_ptr<Interner> interner = nullptr) const;
+
+    /**
+     * @brief Scan the PL/0 source code held by a source buffer lazily, one token at a time.
+     * @param source The source buffer. Identifiers are converted to lowercase in it.
+     * @param interner The table to intern the identifiers in, or nullptr for a new one.
+     * @return The stream of tokens.
+     */
+    TokenStream stream(std::shared_ptr<SourceBuffer> source,
+                       std::shared_ptr<Interner> interner = nullptr) const;
+
+    /**
+     * @brief Apply an edit to a document in place, and re-lex only the damaged region.
+     * @param document The source and the tokens before the edit, e.g.
+     *      TokenDocument(tokenize(srcFile, interner), interner). They are replaced by those
+     *      after the edit, and new identifiers are interned in the table of the document.
+     * @param edit The edit.
+     * @throw std::out_of_range If the edit is out of the source.
+     * @note Lexing starts from the last token boundary before the edit, and stops as soon as a
+     *      token after the edit starts where an old token started, or the damaged segments end.
+     *      Only the damaged segments of the document are copied and rebuilt, so the time
+     *      depends on the edit and the segment size rather than the file, except for the shift
+     *      of the starts of the later segments (see TokenDocument).
+     * @note Only the invalid tokens in the re-lexed region are reported.
+     * @note The edit is applied to the text held by the document, in which identifiers have
+     *      already been converted to lowercase.
+     */
+    void relex(TokenDocument& document, const SourceEdit& edit) const;
+
+    /**
+     * @brief Set the number of threads used by tokenize() in the table-driven mode.
+     * @param threadCount The number of threads, or 0 to use one per hardware thread (default).
+     * @note Large files are split into chunks which are lexed on separate threads.
+     *      The tokens and the diagnostics are the same as those of a single-threaded run.
+     */
+    inline void setThreadCount(size_t threadCount)
+    {
+        m_threadCount = threadCount;
+    }
+
+    /**
+     * @return The number of threads used by tokenize() in the table-driven mode.
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @brief Cache the tokens of tokenize() in a directory, or disable the cache (default).
+     * @param directory The directory of the cache, or an empty string to disable it.
+     * @note If the cache holds the tokens of a source with the same content, tokenize() returns
+     *      them without scanning the source. The invalid tokens are still reported.
+     * @see TokenCache
+     */
+    inline void setCacheDirectory(std::string directory)
+    {
+        m_cacheDirectory = std::move(directory);
+    }
+
+    /**
+     * @return The directory of the token cache, or an empty string if it is disabled.
+     */
+    inline const std::string& getCacheDirectory() const
+    {
+        return m_cacheDirectory;
+    }
 
     /**
      * @brief Encode a token into a string.
      * @param token The token to be encoded.
+     * @return The code of the kind of the token, e.g. "becomes" for ":=".
+     * @note It is a table lookup (see TOKEN_KIND_CODES).
      */
-    static std::string encode(const Token& token) noexcept;
+    static std::string_view encode(const Token& token) noexcept;
 
 private:
-    Token getKeywordOrIdentifier();
-    Token getNumber();
-    Token getOperator();
-    Token getDelimiter();
-    Token getUnknownSymbol();
+    /**
+     * @brief Lex a source buffer into {tokens}, in the mode of the lexer, and intern the
+     *      identifiers in {interner}.
+     */
+    void lex(const std::shared_ptr<SourceBuffer>& source, Interner& interner,
+             TokenList& tokens) const;
+
+    /**
+     * @brief Lex a source buffer in chunks on {threadCount} threads.
+     * @param tokens The list to append the tokens to.
+     */
+    void tokenizeInParallel(SourceBuffer& source, Interner& interner, TokenList& tokens,
+                            size_t threadCount) const;
+
+    Token getKeywordOrIdentifier(Scanner& scanner, Interner& interner) const;
+    Token getNumber(Scanner& scanner) const;
+    Token getOperator(Scanner& scanner) const;
+    Token getDelimiter(Scanner& scanner) const;
+    Token getUnknownSymbol(Scanner& scanner) const;
 
 private:
-    std::unique_ptr<Scanner> m_scanner = nullptr;
+    Mode m_mode;
+    size_t m_threadCount = 0;
+    std::string m_cacheDirectory;
 };
 }  // namespace PL0
@@ -1,5 +1,6 @@
 #pragma once
 #include "PL0/Utils/Error.hpp"
+#include "PL0/Utils/Interner.hpp"
 #include <map>
 #include <memory>
 #include <string>
@@ -17,6 +18,8 @@ struct Quadruple
 };
 
 /**
+ * @note The names and the value are IDs in the interner of the optimizer.
+ *      The examples below show the strings they stand for.
  * @note For an operator node,
  *      e.g. T1 := a + b, T2 := a + b
  *          - names: {T1, T2}
@@ -53,8 +56,8 @@ struct DAGNode
 {
     using NodePtr = std::shared_ptr<DAGNode>;
 
-    std::vector<std::string> names;  // Names of variables that this node represents.
-    std::string value;  // The value of this node, can be a constant, an operator, or an identifier.
+    std::vector<uint32_t> names;  // Names of variables that this node represents.
+    uint32_t value;  // The value of this node, can be a constant, an operator, or an identifier.
     std::vector<NodePtr> operands;  // Operands of this node (if value is an operator)
     std::optional<int> constant;    // The constant value of this node (if it is a constant).
 };
@@ -64,7 +67,14 @@ class Optimizer
     using NodePtr = std::shared_ptr<DAGNode>;
 
 public:
-    Optimizer() = default;
+    /**
+     * @param interner The table to intern the names in, e.g. the one of the lexer.
+     *      A new table is used if it is nullptr.
+     */
+    Optimizer(std::shared_ptr<Interner> interner = nullptr)
+        : m_interner(interner ? std::move(interner) : std::make_shared<Interner>())
+    {
+    }
 
     std::vector<Quadruple> optimize(const std::vector<Quadruple>& quads);
 
@@ -90,10 +100,15 @@ private:
     }
 
 private:
+    std::shared_ptr<Interner> m_interner;
+
     std::vector<NodePtr> m_nodes;  // A vector of all nodes in the DAG.
 
-    std::map<std::string, NodePtr>
-        m_nodePtrMap;  // A hash map mapping variable names to their corresponding nodes.
+    /**
+     * @note Maps the ID of a name to its corresponding node (nullptr if it has no node yet).
+     *      IDs are dense, so a vector works as the map.
+     */
+    std::vector<NodePtr> m_nodePtrMap;
 };
 
 }  // namespace PL0
\ No newline at end of file
@@ -1,17 +1,108 @@
 #pragma once
+#include "Ast.hpp"
 #include "Token.hpp"
-#include <vector>
+#include "TokenBuffer.hpp"
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace PL0
 {
 /**
  * @brief The Parser class is an abstract class that defines the interface for parsing tokens.
+ * @note Parsing does not modify the parser, so the tables of a parser are built once and can be
+ *      shared by threads that parse at the same time.
 */
 class Parser
 {
 public:
-    virtual void parse(const std::vector<Token>& tokens) = 0;
+    virtual ~Parser() = default;
+
+    /**
+     * @brief Parse the tokens pulled from a token source.
+     * @param tokens The token source. The tokens are read one by one with one-token lookahead.
+     */
+    virtual void parse(TokenSource& tokens) const = 0;
+
+    /**
+     * @brief Parse the given tokens.
+     * @param tokens The tokens to parse.
+     */
+    void parse(const std::vector<Token>& tokens) const
+    {
+        TokenSpanSource source(tokens);
+        parse(source);
+    }
+
+    /**
+     * @brief Parse the given tokens. Diagnostics will point at the lines and columns.
+     * @param tokens The tokens to parse.
+     */
+    void parse(const TokenList& tokens) const
+    {
+        TokenSpanSource source(tokens, tokens.getSource());
+        parse(source);
+    }
+
+    /**
+     * @brief Parse the tokens held by a token buffer. Diagnostics will point at the lines and
+     *      columns.
+     * @param tokens The tokens to parse.
+     */
+    void parse(const TokenBuffer& tokens) const
+    {
+        TokenBufferSource source(tokens);
+        parse(source);
+    }
+
+    /**
+     * @brief Parse the tokens pulled from a token source, and build the syntax tree of the input.
+     * @param tokens The token source.
+     * @param unit The compilation unit to build the tree in, which is reset first. If there is an
+     *      error, no tree is built.
+     * @note The default implementation only parses, and builds no tree, e.g. for the parsers
+     *      generated by ParserGenerator.
+     */
+    virtual void parse(TokenSource& tokens, CompilationUnit& unit) const
+    {
+        unit.reset(tokens.getSource());
+        parse(tokens);
+    }
+
+    /**
+     * @brief Parse the given tokens, and build the syntax tree of the input.
+     * @param tokens The tokens to parse.
+     * @param unit The compilation unit to build the tree in.
+     */
+    void parse(const TokenList& tokens, CompilationUnit& unit) const
+    {
+        TokenSpanSource source(tokens, tokens.getSource());
+        parse(source, unit);
+    }
+
+protected:
+    /**
+     * @brief The offset of the lookahead once the token source is exhausted.
+     */
+    static constexpr uint32_t NO_OFFSET = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Locate a byte in the source of the tokens for a diagnostic.
+     * @param tokens The token source.
+     * @param offset The offset of the byte, or NO_OFFSET for the end of the source.
+     * @return "line:column: ", or an empty string if the source is unknown.
+     */
+    static std::string locate(const TokenSource& tokens, uint32_t offset)
+    {
+        const auto& source = tokens.getSource();
+        if (!source) {
+            return "";
+        }
+        return source->getLocation(offset != NO_OFFSET ? offset : source->size()).toString() +
+               ": ";
+    }
 };
 
-}  // namespace PL0
\ No newline at end of file
+}  // namespace PL0
@@ -0,0 +1,66 @@
+#pragma once
+#include "Grammar.hpp"
+#include "PredictionTable.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief Generate the C++ code of a recursive-descent parser from the tables of an LL(1) grammar.
+ * @note The generated parser has one function per non-terminal, which switches on the integer ID
+ *      of the lookahead terminal by the SELECT sets of the rules, and the actions are direct calls
+ *      to the functions they are bound to. It accepts the same language and reports the same
+ *      diagnostics as the table-driven parser of the grammar:
+ *          - A grammar without actions is parsed like LL1Parser.
+ *          - A grammar with actions is parsed like SemanticLL1Parser, whose attribute passing is
+ *            resolved when the code is generated.
+ * @note A rule whose last non-terminal is its left-hand side, followed by actions only, is a loop
+ *      instead of a recursion, so the stack does not grow with the length of a list. Nesting is
+ *      limited to MAX_DEPTH calls, beyond which the generated parser reports a syntax error
+ *      instead of overflowing the stack.
+ */
+class ParserGenerator
+{
+public:
+    static constexpr size_t MAX_DEPTH = 10000;
+
+    /**
+     * @throw std::runtime_error If an action is bound to an unknown function, or an index offset
+     *      does not point into the right-hand side of its rule.
+     */
+    explicit ParserGenerator(const ParseTables& tables);
+
+    /**
+     * @brief Generate a header which defines the parser as a subclass of Parser.
+     * @param className The name of the class, which is defined in namespace PL0::Generated.
+     * @param grammarName The name of the grammar in the comments, e.g. the grammar file.
+     */
+    std::string generate(std::string_view className, std::string_view grammarName) const;
+
+private:
+    std::string getFunctionName(SymbolId nonTerminal) const;
+
+    /**
+     * @return The position of the last non-terminal of a rule if the rule is a loop, i.e. the
+     *      non-terminal is the left-hand side, and only actions follow it.
+     */
+    std::optional<size_t> getLoopPos(uint32_t rule) const;
+
+    std::string getRuleText(uint32_t rule) const;
+
+    void generateFunction(std::string& code, SymbolId nonTerminal) const;
+    void generateRule(std::string& code, int indent, uint32_t rule) const;
+    void generateUnwind(std::string& code, int indent, uint32_t rule) const;
+
+private:
+    PredictionTable m_table;
+    std::vector<int> m_indexOffsets;
+    std::vector<std::string> m_actionFuncs;  // The function of each action symbol ID, if any.
+    bool m_semantic;                         // Whether the grammar has actions.
+    std::vector<SymbolId> m_ruleLhs;         // The left-hand side of each rule.
+    std::vector<std::string> m_functionNames;  // The function of each non-terminal.
+};
+}  // namespace PL0
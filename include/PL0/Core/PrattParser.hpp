@@ -0,0 +1,85 @@
+#pragma once
+#include "Parser.hpp"
+#include <cstdint>
+
+namespace PL0
+{
+/**
+ * @brief The engine which parses the built-in grammar of expressions of LL1Parser and
+ *      SemanticLL1Parser.
+ */
+enum class ExpressionEngine : uint8_t
+{
+    Table,  // The table-driven LL(1) loop over the prediction table.
+    Pratt,  // PrattParser, which gives the same results and diagnostics.
+};
+
+/**
+ * @brief Parser of arithmetic expressions using precedence climbing (Pratt parsing).
+ * @note The syntax is the grammar of expressions of LL1Parser:
+ *  expression -> [+ | -] term {(+ | -) term}
+ *  term       -> factor {(* | /) factor}
+ *  factor     -> id | num | ( expression )
+ *      Instead of expanding E, E', E'', T, T' and F for every operand, the parser reads an
+ *      operand, then looks up the precedence of the operator after it in a small table, and
+ *      reduces the pending operators which bind at least as tightly. "a + b" takes a few
+ *      comparisons instead of about ten pushes and pops of the analysis stack.
+ * @note The pending operators and open parentheses are kept in a stack on the heap, so the
+ *      nesting is only limited by memory, as in the table-driven parsers.
+ * @note The errors are detected at the same tokens as by the table-driven parsers, and reported
+ *      with the same messages, e.g. "id is not allowed." where no rule predicts the lookahead, and
+ *      "The terminal symbol ) does not match the top of the input stack ##." where an open
+ *      parenthesis is not closed. In Mode::Semantics, the semantic errors and the result are
+ *      those of SemanticLL1Parser, whose action functions compute the values.
+ */
+class PrattParser : public Parser
+{
+public:
+    enum class Mode : uint8_t
+    {
+        Syntax,     // Check the syntax, as LL1Parser does.
+        Semantics,  // Also compute and print the value, as SemanticLL1Parser does.
+    };
+
+    explicit PrattParser(Mode mode = Mode::Syntax) : m_mode(mode)
+    {
+    }
+
+    using Parser::parse;
+
+    /**
+     * @brief Parse the tokens pulled from a token source.
+     * @param tokens The token source.
+     * @note Once there is an error, the parsing process will stop immediately, and the remaining
+     *      tokens will not be read.
+     */
+    virtual void parse(TokenSource& tokens) const override;
+
+    /**
+     * @brief Parse the tokens pulled from a token source, and build the tree of the expression.
+     * @param tokens The token source.
+     * @param unit The compilation unit to build the tree in, whose root is the expression.
+     * @note The tree is the one ExpressionBuilder builds from the same tokens, with the sign
+     *      scope of the grammar of the mode: ExpressionBuilder::SignScope::Expression in
+     *      Mode::Semantics, so the tree computes the printed value.
+     */
+    virtual void parse(TokenSource& tokens, CompilationUnit& unit) const override;
+
+private:
+    template <bool SEMANTICS>
+    class Context;  // The state of one parse.
+
+    /**
+     * @brief Parse the tokens, and build the tree in {unit} if it is not null.
+     * @return Whether the input is correct.
+     */
+    bool analyze(TokenSource& tokens, CompilationUnit* unit) const;
+
+    template <bool SEMANTICS>
+    bool analyze(TokenSource& tokens, CompilationUnit* unit) const;
+
+private:
+    Mode m_mode;
+};
+
+}  // namespace PL0
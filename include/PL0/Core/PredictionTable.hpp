@@ -0,0 +1,178 @@
+#pragma once
+#include "Rule.hpp"
+#include "Symbol.hpp"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief An LL(1) prediction table indexed by dense symbol IDs.
+ * @note The symbols are numbered when the table is built:
+ *          - [0, terminal count): the terminals, the last of which is ENDSYM
+ *          - [terminal count, terminal count + non-terminal count): the non-terminals
+ *          - the rest: the other symbols of the right-hand sides, e.g. action symbols
+ *      The table is a flat [non-terminal × terminal] array of rule indices, and the right-hand
+ *      sides of all the rules are held in one pool of symbol IDs, without ε. So predicting a rule
+ *      is one array access, and a parser runs on integers only.
+ * @note The table views its arrays. A table built at run time owns them in a storage that its
+ *      copies share, and which is never modified. A table of a built-in grammar views the arrays
+ *      generated at compile time (see StaticTable), so it costs nothing to build.
+ */
+class PredictionTable
+{
+public:
+    static constexpr uint32_t NO_RULE = std::numeric_limits<uint32_t>::max();
+    static constexpr SymbolId NO_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+    PredictionTable() = default;
+
+    /**
+     * @param analyzer The analyzer whose SELECT sets have been calculated.
+     * @param rhsList The right-hand side of each rule to store in the table, e.g. with action
+     *      symbols, or empty for the right-hand sides of the analyzer.
+     * @note If the SELECT sets of two rules of a non-terminal overlap, the later rule wins.
+     */
+    explicit PredictionTable(const RuleAnalyzer& analyzer,
+                             const std::vector<std::vector<Symbol>>& rhsList = {});
+
+    /**
+     * @brief Rebuild a table from the arrays of another one, e.g. loaded from a file.
+     * @throw std::runtime_error If the arrays do not make a valid table.
+     */
+    PredictionTable(std::vector<Symbol> names, uint32_t terminalCount, uint32_t nonTerminalCount,
+                    SymbolId beginSym, std::vector<uint32_t> cells,
+                    std::vector<uint32_t> rhsOffsets, std::vector<SymbolId> rhsPool);
+
+    /**
+     * @brief View the arrays of a table without copying or checking them.
+     * @note The arrays must outlive the table and all its copies, e.g. arrays generated at
+     *      compile time.
+     */
+    static PredictionTable view(std::span<const std::string_view> names, uint32_t terminalCount,
+                                uint32_t nonTerminalCount, SymbolId beginSym,
+                                std::span<const uint32_t> cells,
+                                std::span<const uint32_t> rhsOffsets,
+                                std::span<const SymbolId> rhsPool);
+
+public:
+    /**
+     * @return The ID of a symbol, or NO_SYMBOL if the symbol is not in the table.
+     */
+    SymbolId findSymbol(std::string_view symbol) const;
+
+    inline std::string_view getName(SymbolId id) const
+    {
+        return m_names[id];
+    }
+
+    inline bool isTerminal(SymbolId id) const
+    {
+        return id < m_terminalCount;
+    }
+
+    inline bool isNonTerminal(SymbolId id) const
+    {
+        return id >= m_terminalCount && id < m_terminalCount + m_nonTerminalCount;
+    }
+
+    inline SymbolId getEndSym() const
+    {
+        return m_terminalCount - 1;
+    }
+
+    inline SymbolId getBeginSym() const
+    {
+        return m_beginSym;
+    }
+
+    /**
+     * @param nonTerminal The ID of a non-terminal.
+     * @param terminal The ID of a terminal.
+     * @return The index of the rule to expand {nonTerminal} by when {terminal} is the
+     *      lookahead, or NO_RULE.
+     */
+    inline uint32_t predict(SymbolId nonTerminal, SymbolId terminal) const
+    {
+        return m_cells[(nonTerminal - m_terminalCount) * m_terminalCount + terminal];
+    }
+
+    /**
+     * @return The right-hand side of a rule, without ε.
+     */
+    inline std::span<const SymbolId> getRhs(uint32_t rule) const
+    {
+        return m_rhsPool.subspan(m_rhsOffsets[rule], m_rhsOffsets[rule + 1] - m_rhsOffsets[rule]);
+    }
+
+    inline size_t getSymbolCount() const
+    {
+        return m_names.size();
+    }
+
+    inline size_t getTerminalCount() const
+    {
+        return m_terminalCount;
+    }
+
+    inline size_t getNonTerminalCount() const
+    {
+        return m_nonTerminalCount;
+    }
+
+    inline size_t getRuleCount() const
+    {
+        return m_rhsOffsets.empty() ? 0 : m_rhsOffsets.size() - 1;
+    }
+
+    /**
+     * @note The arrays of the table, which the table can be rebuilt from.
+     */
+    inline std::span<const std::string_view> getNames() const
+    {
+        return m_names;
+    }
+
+    inline std::span<const uint32_t> getCells() const
+    {
+        return m_cells;
+    }
+
+    inline std::span<const uint32_t> getRhsOffsets() const
+    {
+        return m_rhsOffsets;
+    }
+
+    inline std::span<const SymbolId> getRhsPool() const
+    {
+        return m_rhsPool;
+    }
+
+    void print() const;
+
+private:
+    struct Storage;  // The arrays of a table built at run time.
+
+    /**
+     * @brief Own the arrays of a storage, and view them.
+     */
+    void adopt(std::shared_ptr<Storage> storage);
+
+private:
+    std::shared_ptr<const Storage> m_storage;  // Null if the arrays are not owned.
+
+    std::span<const std::string_view> m_names;  // The name of each symbol.
+    uint32_t m_terminalCount = 0;
+    uint32_t m_nonTerminalCount = 0;
+    SymbolId m_beginSym = NO_SYMBOL;
+
+    std::span<const uint32_t> m_cells;       // [non-terminal × terminal] -> rule index
+    std::span<const uint32_t> m_rhsOffsets;  // Rule i is [m_rhsOffsets[i], m_rhsOffsets[i + 1]).
+    std::span<const SymbolId> m_rhsPool;
+};
+}  // namespace PL0
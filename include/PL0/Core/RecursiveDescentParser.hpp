@@ -0,0 +1,56 @@
+#pragma once
+#include "Parser.hpp"
+
+namespace PL0
+{
+/**
+ * @brief Syntax parser for whole PL/0 programs using hand-written recursive descent.
+ * @note The syntax of PL/0 programs:
+ *  program    -> block .
+ *  block      -> [const id = num {, id = num} ;] [var id {, id} ;] {procedure id ; block ;}
+ *                statement
+ *  statement  -> [id := expression | call id | begin statement {; statement} end
+ *                | if condition then statement | while condition do statement
+ *                | read ( id {, id} ) | write ( expression {, expression} )]
+ *  condition  -> odd expression | expression (= | # | < | <= | > | >=) expression
+ *  expression -> [+ | -] term {(+ | -) term}
+ *  term       -> factor {(* | /) factor}
+ *  factor     -> id | num | ( expression )
+ * @note The tokens are parsed in a single pass with one-token lookahead, and nothing is allocated
+ *      per token. Lists are loops, so the stack only grows with the nesting of procedures,
+ *      statements and parentheses. Nesting is limited to MAX_DEPTH levels, beyond which a syntax
+ *      error is reported instead of overflowing the stack.
+ */
+class RecursiveDescentParser : public Parser
+{
+public:
+    static constexpr size_t MAX_DEPTH = 10000;
+
+    using Parser::parse;
+
+    /**
+     * @brief Parse the tokens pulled from a token source.
+     * @param tokens The token source.
+     * @note Once there is a syntax error, the parsing process will stop immediately, and the
+     *      remaining tokens will not be read.
+     */
+    virtual void parse(TokenSource& tokens) const override;
+
+    /**
+     * @brief Parse the tokens pulled from a token source, and build the tree of the program.
+     * @param tokens The token source.
+     * @param unit The compilation unit to build the tree in, whose root is the Program.
+     */
+    virtual void parse(TokenSource& tokens, CompilationUnit& unit) const override;
+
+private:
+    class Context;  // The state of one parse.
+
+    /**
+     * @brief Parse the tokens, and build the tree in {unit} if it is not null.
+     * @return Whether the input is correct.
+     */
+    bool analyze(TokenSource& tokens, CompilationUnit* unit) const;
+};
+
+}  // namespace PL0
@@ -1,5 +1,6 @@
 #pragma once
 #include "Symbol.hpp"
+#include <cstdint>
 #include <map>
 #include <numeric>
 #include <set>
@@ -23,6 +24,20 @@ struct Rule
 class RuleAnalyzer
 {
 public:
+    /**
+     * @brief The way the sets are represented while they are calculated.
+     * @note Both modes produce the same sets.
+     */
+    enum class Mode
+    {
+        Sets,     // std::set<Symbol> per symbol, which suits small hand-written grammars.
+        Bitsets,  // Fixed-width bitsets over dense terminal IDs, so a union is a word-wide OR.
+    };
+
+    RuleAnalyzer(Mode mode = Mode::Sets) : m_mode(mode)
+    {
+    }
+
     /**
      * @brief Add a rule to the analyzer.
      * @param lhs The left-hand side symbol.
@@ -35,6 +50,7 @@ public:
 
     /**
      * @brief Calculate SELECT sets for all rules.
+     * @note The FIRST and FOLLOW sets are calculated on the way, in the mode of the analyzer.
      */
     void calcSelectSets();
 
@@ -75,6 +91,22 @@ public:
         return m_selectSet[ruleIndex];
     }
 
+    /**
+     * @return All the terminal symbols, without ENDSYM.
+     */
+    inline const std::set<Symbol>& getTerminals() const
+    {
+        return m_terminals;
+    }
+
+    /**
+     * @return All the non-terminal symbols.
+     */
+    inline const std::set<Symbol>& getNonTerminals() const
+    {
+        return m_nonTerminals;
+    }
+
     /**
      * @return Whether the symbol is a non-terminal.
      */
@@ -110,8 +142,16 @@ private:
     std::pair<std::set<Symbol>, bool> calcFirstSetOfSyms(const std::vector<Symbol>& syms,
                                                          size_t beginIdx, size_t endIdx) const;
 
+    /**
+     * @brief Calculate the FIRST, FOLLOW and SELECT sets with bitsets, and then store them as
+     *      std::set<Symbol> like the Sets mode does.
+     */
+    void calcSelectSetsWithBitsets();
+
     /**
      * @brief Calculate the FIRST set of each symbol (including terminals and non-terminals).
+     * @note The non-terminals are solved by the strongly connected components of their
+     *      dependencies, so each FIRST set is only recalculated when one it depends on has grown.
      * @note The result will be saved in m_firstSet.
      * @note The FIRST set of each rule will be stored temporarily in m_firstSetCache for SELECT set
      *      calculation.
@@ -119,11 +159,13 @@ private:
     void calcFirstSets();
     /**
      * @brief Calculate the FOLLOW set of each non-terminal symbol.
+     * @note It must be called after calcFirstSets(), and is solved the same way.
      * @note The result will be saved in m_followSet.
      */
     void calcFollowSets();
 
 private:
+    Mode m_mode;
     Symbol m_beginSym;                // The begin symbol of the syntax.
     std::set<Symbol> m_terminals;     // All terminal symbols.
     std::set<Symbol> m_nonTerminals;  // All non-terminal symbols.
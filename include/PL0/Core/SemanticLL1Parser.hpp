@@ -1,12 +1,16 @@
 #pragma once
 #include "Action.hpp"
+#include "Grammar.hpp"
 #include "Parser.hpp"
-#include "Rule.hpp"
+#include "PrattParser.hpp"
+#include "PredictionTable.hpp"
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
 
 namespace PL0
 {
-constexpr int NULL_OFFSET = -999999999;  // The value does not need to be passed.
-
 /**
  * @brief Semantic parser for PL/0 using LL(1) parsing.
  * @note This parser can only parse arithmetic expressions.
@@ -14,69 +18,85 @@ constexpr int NULL_OFFSET = -999999999;  // The value does not need to be passed
 class SemanticLL1Parser : public Parser
 {
     /**
-     * @note The prediction table for LL(1) parsing.
-     *    < left-hand side, <symbol in SELECT set, right-hand side> >
+     * @note The action function type.
+     * @note std::span<const int>: Operands for the action function.
      */
-    using PredictionTable = std::map<Symbol, std::map<Symbol, std::vector<Symbol>>>;
+    using ActionFunc = Action::Function;
+
+public:
     /**
-     * @note The offset table for non-terminal symbols.
-     *   < non-terminal symbol, <symbol, offset> >
+     * @param engine The engine which parses the built-in grammar. PrattParser by default, which
+     *      computes the same values with the same action functions in fewer steps.
      */
-    using IndexOffsetTable = std::map<Symbol, std::map<Symbol, int>>;
+    explicit SemanticLL1Parser(ExpressionEngine engine = ExpressionEngine::Pratt);
+
     /**
-     * @note The action function type.
-     * @note const std::vector<int>&: Operands for the action function.
+     * @brief Build the parser from the tables of a grammar, e.g. loaded from a grammar file.
+     * @throw std::runtime_error If an action is not bound to a known function.
+     * @note The tables are always parsed by the table-driven loop.
      */
-    using ActionFunc = std::function<int(const std::vector<int>&)>;
+    explicit SemanticLL1Parser(const ParseTables& tables);
 
-public:
-    SemanticLL1Parser();
+    using Parser::parse;
 
     /**
-     * @brief Parse the given tokens.
-     * @param tokens The tokens to parse.
-     * @note Once there is a syntax or semantic error, the parsing process will stop immediately.
+     * @brief Parse the tokens pulled from a token source.
+     * @param tokens The token source.
+     * @note Once there is a syntax or semantic error, the parsing process will stop immediately,
+     *      and the remaining tokens will not be read.
      */
-    virtual void parse(const std::vector<Token>& tokens) override;
-
-private:
-    void initSyntax();
+    virtual void parse(TokenSource& tokens) const override;
 
     /**
-     * @brief Add a rule to the syntax analyzer.
-     * @param lhs The left-hand side of the rule.
-     * @param rhs The right-hand side of the rule.
-     * @param indexOffset The offset to locate where the value of an non-terminal symbol should be
-     *      passed to.
+     * @brief Parse the tokens pulled from a token source, and build the tree of the expression.
+     * @param tokens The token source.
+     * @param unit The compilation unit to build the tree in, whose root is the expression.
+     * @note The tree is built from the terminals matched (see ExpressionBuilder). A leading
+     *      minus negates the whole expression, as E -> - E' {2} does, so the tree computes the
+     *      printed value.
      */
-    void addRule(const Symbol& lhs, const std::vector<Symbol>& rhs, int indexOffset = NULL_OFFSET);
+    virtual void parse(TokenSource& tokens, CompilationUnit& unit) const override;
 
+private:
     /**
-     * @brief Set the action function for the given action symbol.
-     * @param actionSym The action symbol. e.g. "10"
-     * @param func The action function.
+     * @brief Parse the tokens, and feed the terminals matched to {builder} if it is not null.
+     * @return Whether the input is correct.
      */
-    void setActionFunc(const std::string& actionSym, const ActionFunc& func);
+    bool analyze(TokenSource& tokens, ExpressionBuilder* builder) const;
 
+private:
     /**
-     * @brief Generate the prediction table and the index offset table.
+     * @brief Look up the symbols the parser handles by themselves in the prediction table.
      */
-    void generateTables();
+    void initSymbols();
 
 private:
-    void printPredictionTable();
-    void printState(const std::vector<Element>& analysisStack,
-                    const std::vector<std::string>& inputStack);
+    void printPredictionTable() const;
+    void printState(const std::vector<Element>& analysisStack, SymbolId lookahead) const;
 
 private:
-    RuleAnalyzer m_analyzer;
+    struct Storage;  // The arrays of a parser built from the tables of a grammar file.
+
+    std::shared_ptr<const Storage> m_storage;  // Null for the built-in grammar.
 
     PredictionTable m_predictionTable;
-    IndexOffsetTable m_indexOffsetTable;
-    std::map<std::string, ActionFunc> m_actionFuncs;
+    std::span<const ActionFunc> m_actionFuncs;  // The action function of each symbol ID, if any.
+
+    /**
+     * @note The index offset of each rule.
+     *      The index offset only depends on the rule, so it is looked up by the rule predicted.
+     */
+    std::span<const int> m_indexOffsets;
+
+    /**
+     * @brief The terminal of each token kind, or PredictionTable::NO_SYMBOL if the grammar does
+     *      not use it.
+     */
+    std::array<SymbolId, TOKEN_KIND_COUNT> m_kindSymbols;
+    SymbolId m_idSym = PredictionTable::NO_SYMBOL;
+    SymbolId m_numSym = PredictionTable::NO_SYMBOL;
 
-    std::vector<std::vector<Symbol>> m_rhsWithActions;
-    std::vector<int> m_indexOffsets;
+    std::optional<PrattParser> m_pratt;  // The engine of the built-in grammar, if it is used.
 };
 
 }  // namespace PL0
\ No newline at end of file
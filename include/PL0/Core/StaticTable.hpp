@@ -0,0 +1,388 @@
+#pragma once
+#include "Grammar.hpp"
+#include "PredictionTable.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief A rule of a grammar built into the compiler, written as in grammar files (see Grammar).
+ * @note The right-hand side is a string of symbols separated by spaces, e.g. "+ T {6} E'' {7}",
+ *      where {n} is an action, and ε stands for an empty right-hand side.
+ */
+struct StaticRule
+{
+    std::string_view lhs;
+    std::string_view rhs;
+    int indexOffset = NULL_OFFSET;
+};
+
+/**
+ * @brief The compile-time counterpart of RuleAnalyzer, which also lays out the prediction table.
+ * @note The symbols are numbered as PredictionTable does, and the SELECT sets are calculated by
+ *      the same rules, so the table is the same as the one built at run time. If the SELECT sets
+ *      of two rules of a non-terminal overlap, the later rule wins, and a conflict is counted.
+ * @note It only runs in constant evaluation, where its vectors are transient. StaticTable copies
+ *      the results into arrays.
+ */
+class StaticRuleAnalyzer
+{
+public:
+    constexpr explicit StaticRuleAnalyzer(std::span<const StaticRule> rules)
+    {
+        // 1) Collect the terminals, the non-terminals and the actions.
+        std::vector<std::string_view> terminals;
+        std::vector<std::string_view> nonTerminals;
+        std::vector<std::string_view> actions;  // In the order they appear
+        std::vector<std::vector<std::string_view>> rhsList;
+        for (const StaticRule& rule : rules) {
+            nonTerminals.push_back(rule.lhs);
+            rhsList.push_back(split(rule.rhs));
+            for (std::string_view sym : rhsList.back()) {
+                if (isAction(sym)) {
+                    std::string_view name = sym.substr(1, sym.size() - 2);
+                    if (std::ranges::find(actions, name) == actions.end()) {
+                        actions.push_back(name);
+                    }
+                } else if (sym != "ε") {
+                    (isNonTerminal(sym) ? nonTerminals : terminals).push_back(sym);
+                }
+            }
+        }
+        sortUnique(terminals);
+        sortUnique(nonTerminals);
+
+        // 2) Number the symbols: terminals, ENDSYM, non-terminals, and then the actions.
+        m_names = terminals;
+        m_names.push_back("##");  // ENDSYM
+        m_terminalCount = static_cast<uint32_t>(m_names.size());
+        m_names.insert(m_names.end(), nonTerminals.begin(), nonTerminals.end());
+        m_nonTerminalCount = static_cast<uint32_t>(nonTerminals.size());
+        m_names.insert(m_names.end(), actions.begin(), actions.end());
+        m_beginSym = findSymbol(rules.front().lhs);
+
+        // 3) Pool the right-hand sides. The actions are left out of the syntax.
+        std::vector<uint32_t> lhsList;
+        std::vector<std::vector<uint32_t>> syntax(rules.size());
+        m_rhsOffsets.push_back(0);
+        for (size_t i = 0; i < rules.size(); ++i) {
+            lhsList.push_back(findSymbol(rules[i].lhs) - m_terminalCount);
+            for (std::string_view sym : rhsList[i]) {
+                if (sym == "ε") {
+                    continue;
+                }
+                SymbolId id = findSymbol(sym);
+                m_rhsPool.push_back(id);
+                if (!isAction(sym)) {
+                    syntax[i].push_back(id);
+                }
+            }
+            m_rhsOffsets.push_back(static_cast<uint32_t>(m_rhsPool.size()));
+        }
+
+        // 4) FIRST and FOLLOW sets, as rows of flags over the terminals and ε.
+        const size_t width = m_terminalCount + 1;
+        const size_t epsilon = m_terminalCount;
+        std::vector<bool> first(m_nonTerminalCount * width);
+        std::vector<bool> follow(m_nonTerminalCount * width);
+        std::vector<bool> row(width);
+
+        /**
+         * @brief Calculate the FIRST set of syms[begin, end) into {row}.
+         * @return Whether every symbol of the sequence derives ε, in which case ε is in {row}.
+         */
+        auto firstOfSyms = [&](const std::vector<uint32_t>& syms, size_t begin) {
+            std::fill(row.begin(), row.end(), false);
+            for (size_t i = begin; i < syms.size(); ++i) {
+                if (syms[i] < m_terminalCount) {
+                    row[syms[i]] = true;
+                    return false;
+                }
+                size_t nt = syms[i] - m_terminalCount;
+                for (size_t t = 0; t < epsilon; ++t) {
+                    row[t] = row[t] || first[nt * width + t];
+                }
+                if (!first[nt * width + epsilon]) {
+                    return false;
+                }
+            }
+            row[epsilon] = true;
+            return true;
+        };
+        auto merge = [&](std::vector<bool>& sets, size_t nt, size_t end) {
+            bool changed = false;
+            for (size_t t = 0; t < end; ++t) {
+                if (row[t] && !sets[nt * width + t]) {
+                    sets[nt * width + t] = true;
+                    changed = true;
+                }
+            }
+            return changed;
+        };
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 0; i < rules.size(); ++i) {
+                firstOfSyms(syntax[i], 0);
+                changed |= merge(first, lhsList[i], width);
+            }
+        }
+
+        follow[(m_beginSym - m_terminalCount) * width + getEndSym()] = true;
+        changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 0; i < rules.size(); ++i) {
+                for (size_t j = 0; j < syntax[i].size(); ++j) {
+                    if (syntax[i][j] < m_terminalCount) {
+                        continue;
+                    }
+                    size_t nt = syntax[i][j] - m_terminalCount;
+                    bool allHasEpsilon = firstOfSyms(syntax[i], j + 1);
+                    changed |= merge(follow, nt, epsilon);
+                    if (allHasEpsilon) {
+                        for (size_t t = 0; t < epsilon; ++t) {
+                            row[t] = follow[lhsList[i] * width + t];
+                        }
+                        changed |= merge(follow, nt, epsilon);
+                    }
+                }
+            }
+        }
+
+        // 5) Fill the cells by the SELECT sets: FIRST(rhs) - {ε}, plus FOLLOW(lhs) if rhs => ε.
+        m_cells.assign(m_nonTerminalCount * m_terminalCount, PredictionTable::NO_RULE);
+        for (size_t i = 0; i < rules.size(); ++i) {
+            size_t lhs = lhsList[i];
+            bool allHasEpsilon = firstOfSyms(syntax[i], 0);
+            for (size_t t = 0; t < epsilon; ++t) {
+                if (!row[t] && !(allHasEpsilon && follow[lhs * width + t])) {
+                    continue;
+                }
+                uint32_t& cell = m_cells[lhs * m_terminalCount + t];
+                if (cell != PredictionTable::NO_RULE) {
+                    ++m_conflictCount;
+                }
+                cell = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    constexpr SymbolId findSymbol(std::string_view sym) const
+    {
+        if (isAction(sym)) {
+            sym = sym.substr(1, sym.size() - 2);
+        }
+        auto it = std::ranges::find(m_names, sym);
+        return it != m_names.end() ? static_cast<SymbolId>(it - m_names.begin())
+                                   : PredictionTable::NO_SYMBOL;
+    }
+
+    constexpr const std::vector<std::string_view>& getNames() const
+    {
+        return m_names;
+    }
+
+    constexpr uint32_t getTerminalCount() const
+    {
+        return m_terminalCount;
+    }
+
+    constexpr uint32_t getNonTerminalCount() const
+    {
+        return m_nonTerminalCount;
+    }
+
+    constexpr SymbolId getBeginSym() const
+    {
+        return m_beginSym;
+    }
+
+    constexpr SymbolId getEndSym() const
+    {
+        return m_terminalCount - 1;
+    }
+
+    constexpr const std::vector<uint32_t>& getCells() const
+    {
+        return m_cells;
+    }
+
+    constexpr const std::vector<uint32_t>& getRhsOffsets() const
+    {
+        return m_rhsOffsets;
+    }
+
+    constexpr const std::vector<SymbolId>& getRhsPool() const
+    {
+        return m_rhsPool;
+    }
+
+    /**
+     * @return The number of cells that more than one rule is selected for.
+     */
+    constexpr size_t getConflictCount() const
+    {
+        return m_conflictCount;
+    }
+
+private:
+    static constexpr bool isAction(std::string_view sym)
+    {
+        return sym.size() > 2 && sym.front() == '{' && sym.back() == '}';
+    }
+
+    static constexpr bool isNonTerminal(std::string_view sym)
+    {
+        return sym[0] >= 'A' && sym[0] <= 'Z';
+    }
+
+    /**
+     * @return The words of {text} separated by spaces.
+     */
+    static constexpr std::vector<std::string_view> split(std::string_view text)
+    {
+        std::vector<std::string_view> words;
+        for (size_t pos = text.find_first_not_of(' '); pos != std::string_view::npos;) {
+            size_t end = std::min(text.find(' ', pos), text.size());
+            words.push_back(text.substr(pos, end - pos));
+            pos = text.find_first_not_of(' ', end);
+        }
+        return words;
+    }
+
+    static constexpr void sortUnique(std::vector<std::string_view>& syms)
+    {
+        std::ranges::sort(syms);
+        syms.erase(std::unique(syms.begin(), syms.end()), syms.end());
+    }
+
+private:
+    std::vector<std::string_view> m_names;
+    uint32_t m_terminalCount = 0;
+    uint32_t m_nonTerminalCount = 0;
+    SymbolId m_beginSym = PredictionTable::NO_SYMBOL;
+    std::vector<uint32_t> m_cells;
+    std::vector<uint32_t> m_rhsOffsets;
+    std::vector<SymbolId> m_rhsPool;
+    size_t m_conflictCount = 0;
+};
+
+/**
+ * @brief The LL(1) tables of a built-in grammar, generated at compile time into static arrays.
+ * @tparam RULES The rules, an array of StaticRule. The left-hand side of the first rule is the
+ *      begin symbol.
+ * @note The grammar must be LL(1), which is checked by a static_assert.
+ */
+template <const auto& RULES>
+class StaticTable
+{
+    struct Sizes
+    {
+        size_t symbolCount;
+        size_t cellCount;
+        size_t ruleCount;
+        size_t poolSize;
+        size_t conflictCount;
+    };
+
+    static constexpr Sizes SIZES = [] {
+        StaticRuleAnalyzer analyzer(RULES);
+        return Sizes{analyzer.getNames().size(), analyzer.getCells().size(),
+                     analyzer.getRhsOffsets().size() - 1, analyzer.getRhsPool().size(),
+                     analyzer.getConflictCount()};
+    }();
+
+    static_assert(SIZES.conflictCount == 0,
+                  "The grammar is not LL(1): more than one rule is selected by a terminal.");
+
+    struct Data
+    {
+        std::array<std::string_view, SIZES.symbolCount> names;
+        uint32_t terminalCount;
+        uint32_t nonTerminalCount;
+        SymbolId beginSym;
+        std::array<uint32_t, SIZES.cellCount> cells;
+        std::array<uint32_t, SIZES.ruleCount + 1> rhsOffsets;
+        std::array<SymbolId, SIZES.poolSize> rhsPool;
+        std::array<int, SIZES.ruleCount> indexOffsets;
+    };
+
+    static constexpr Data DATA = [] {
+        StaticRuleAnalyzer analyzer(RULES);
+        Data data{};
+        std::ranges::copy(analyzer.getNames(), data.names.begin());
+        data.terminalCount = analyzer.getTerminalCount();
+        data.nonTerminalCount = analyzer.getNonTerminalCount();
+        data.beginSym = analyzer.getBeginSym();
+        std::ranges::copy(analyzer.getCells(), data.cells.begin());
+        std::ranges::copy(analyzer.getRhsOffsets(), data.rhsOffsets.begin());
+        std::ranges::copy(analyzer.getRhsPool(), data.rhsPool.begin());
+        for (size_t i = 0; i < SIZES.ruleCount; ++i) {
+            data.indexOffsets[i] = RULES[i].indexOffset;
+        }
+        return data;
+    }();
+
+public:
+    /**
+     * @return A table which views the static arrays.
+     */
+    static PredictionTable getPredictionTable()
+    {
+        return PredictionTable::view(DATA.names, DATA.terminalCount, DATA.nonTerminalCount,
+                                     DATA.beginSym, DATA.cells, DATA.rhsOffsets, DATA.rhsPool);
+    }
+
+    static constexpr std::span<const int> getIndexOffsets()
+    {
+        return DATA.indexOffsets;
+    }
+
+    static constexpr size_t getSymbolCount()
+    {
+        return SIZES.symbolCount;
+    }
+
+    static constexpr size_t getTerminalCount()
+    {
+        return DATA.terminalCount;
+    }
+
+    static constexpr size_t getNonTerminalCount()
+    {
+        return DATA.nonTerminalCount;
+    }
+
+    /**
+     * @return The ID of a symbol, or PredictionTable::NO_SYMBOL if the symbol is not in the table.
+     */
+    static constexpr SymbolId findSymbol(std::string_view sym)
+    {
+        auto it = std::ranges::find(DATA.names, sym);
+        return it != DATA.names.end() ? static_cast<SymbolId>(it - DATA.names.begin())
+                                      : PredictionTable::NO_SYMBOL;
+    }
+
+    /**
+     * @return The ID of each symbol, or PredictionTable::NO_SYMBOL for the symbols not in the
+     *      table, e.g. to translate token kinds.
+     */
+    template <size_t N>
+    static constexpr std::array<SymbolId, N> findSymbols(
+        const std::array<std::string_view, N>& syms)
+    {
+        std::array<SymbolId, N> ids{};
+        for (size_t i = 0; i < N; ++i) {
+            ids[i] = findSymbol(syms[i]);
+        }
+        return ids;
+    }
+};
+}  // namespace PL0
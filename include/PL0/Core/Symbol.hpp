@@ -1,5 +1,9 @@
 #pragma once
+#include <array>
+#include <charconv>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <optional>
 #include <vector>
@@ -10,24 +14,76 @@
 namespace PL0
 {
 using Symbol = std::string;
+using SymbolId = uint32_t;  // The dense ID of a symbol in a prediction table.
 
 constexpr Symbol EPSILON = "";
 constexpr Symbol ENDSYM = "##";
 
+/**
+ * @brief The terminal symbol of each token kind in the grammars.
+ * @note Identifiers and numbers are "id" and "num", operators and delimiters are their text, and
+ *      keywords are their lowercase spelling. Invalid tokens are "nul", which no grammar uses.
+ */
+constexpr std::array<std::string_view, TOKEN_KIND_COUNT> TOKEN_KIND_SYMBOLS = {
+    "nul", "id", "num",
+    "+", "-", "*", "/", "=", "#", "<", "<=", ">", ">=", ":=",
+    "(", ")", ",", ";", ".",
+    "const", "var", "procedure", "begin", "end", "if", "then",
+    "while", "do", "call", "odd", "write", "read"};
+
 /**
  * @brief Translate the token to a symbol.
  * @param token The token.
- * @return The symbol.
+ * @return The symbol, which is a table lookup by the kind of the token.
 */
-Symbol translate2Symbol(const Token& token);
+inline std::string_view translate2Symbol(const Token& token)
+{
+    return TOKEN_KIND_SYMBOLS[static_cast<size_t>(token.kind)];
+}
 
 /**
- * @brief Translate the token value to a symbol.
- * @param tokenValue The token value.
- * @return The symbol.
- * @warning This function is not suitable for keywords.
-*/
-Symbol translate2Symbol(const std::string& tokenValue);
+ * @brief The terminal symbol of each token kind in the grammar of expressions.
+ * @note Every word is an identifier to this grammar, so keywords are "id" as well.
+ */
+constexpr std::array<std::string_view, TOKEN_KIND_COUNT> EXPRESSION_SYMBOLS = [] {
+    std::array<std::string_view, TOKEN_KIND_COUNT> symbols = TOKEN_KIND_SYMBOLS;
+    for (size_t i = static_cast<size_t>(TokenKind::Const); i < TOKEN_KIND_COUNT; ++i) {
+        symbols[i] = "id";
+    }
+    return symbols;
+}();
+
+/**
+ * @brief Translate a token to a symbol of the grammar of expressions.
+ * @note Invalid tokens are translated by their first character, so an invalid identifier like
+ *      12ab is a number, and an unknown character is reported as itself.
+ */
+inline std::string_view translateExpressionSymbol(const Token& token)
+{
+    if (token.type != TokenType::Invalid) {
+        return EXPRESSION_SYMBOLS[static_cast<size_t>(token.kind)];
+    }
+    if (isDigit(token.value[0])) {
+        return "num";
+    } else if (isAlpha(token.value[0])) {
+        return "id";
+    }
+    return token.value;
+}
+
+/**
+ * @return The value of a token translated to "num".
+ * @note An invalid identifier like 12ab takes the value of its leading digits.
+ */
+inline int getNumberValue(const Token& token)
+{
+    if (token.type == TokenType::Number) {
+        return token.number;  // Decoded by the lexer
+    }
+    int value = 0;
+    std::from_chars(token.value.data(), token.value.data() + token.value.size(), value);
+    return value;
+}
 
 ///////////////////////////////////////////////////////////////////////////
 // Element (for semantic analysis)
@@ -44,6 +100,8 @@ enum class SymbolType
 
 /**
  * @brief The element for semantic analysis.
+ * @note The symbol is the ID of the symbol in the prediction table (see PredictionTable).
+ *       The examples below show the symbols they stand for.
  * @note For terminal symbols,
  *          - symbol: The terminal symbol. e.g. "+"
  *          - type: SymbolType::TERMINAL.
@@ -67,11 +125,9 @@ enum class SymbolType
 */
 struct Element
 {
-    Symbol symbol;
+    SymbolId symbol;
     SymbolType type;
-    std::vector<int> values;
-
-    Element(const Symbol& sym, bool synthesized = false);
+    std::vector<int> values = {};
 };
 
 }  // namespace PL0
@@ -1,8 +1,18 @@
 #pragma once
+#include "Keyword.hpp"
+#include "PL0/Utils/Interner.hpp"
+#include "PL0/Utils/SourceBuffer.hpp"
 #include <array>
+#include <charconv>
+#include <cstdio>
 #include <cstdint>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace PL0
 {
@@ -20,50 +30,453 @@ enum class TokenType : uint8_t
     Delimiter
 };
 
+/**
+ * @brief The fine-grained kind of a token: every operator, delimiter and keyword has its own.
+ * @note The keyword kinds are in the order of Keyword, so toKind(Keyword) is an addition.
+ */
+enum class TokenKind : uint8_t
+{
+    Nul = 0,  // Invalid token
+    Ident,
+    Number,
+    Plus,       // +
+    Minus,      // -
+    Times,      // *
+    Slash,      // /
+    Eql,        // =
+    Neq,        // #
+    Lss,        // <
+    Leq,        // <=
+    Gtr,        // >
+    Geq,        // >=
+    Becomes,    // :=
+    LParen,     // (
+    RParen,     // )
+    Comma,      // ,
+    Semicolon,  // ;
+    Period,     // .
+    Const,
+    Var,
+    Procedure,
+    Begin,
+    End,
+    If,
+    Then,
+    While,
+    Do,
+    Call,
+    Odd,
+    Write,
+    Read
+};
+
+constexpr size_t TOKEN_KIND_COUNT = static_cast<size_t>(TokenKind::Read) + 1;
+
+/**
+ * @brief The codes of the token kinds, as written by exp02 (see Lexer::encode).
+ */
+constexpr std::array<std::string_view, TOKEN_KIND_COUNT> TOKEN_KIND_CODES = {
+    "nul", "ident", "number",
+    "plus", "minus", "times", "slash", "eql", "neq", "lss", "leq", "gtr", "geq", "becomes",
+    "lparen", "rparen", "comma", "semicolon", "period",
+    "constsym", "varsym", "proceduresym", "beginsym", "endsym", "ifsym", "thensym",
+    "whilesym", "dosym", "callsym", "oddsym", "writesym", "readsym"};
+
+/**
+ * @brief The type of the tokens of each kind.
+ */
+constexpr std::array<TokenType, TOKEN_KIND_COUNT> TOKEN_KIND_TYPES = [] {
+    std::array<TokenType, TOKEN_KIND_COUNT> types{};
+    for (size_t i = 0; i < TOKEN_KIND_COUNT; ++i) {
+        auto kind = static_cast<TokenKind>(i);
+        if (kind == TokenKind::Nul) {
+            types[i] = TokenType::Invalid;
+        } else if (kind == TokenKind::Ident) {
+            types[i] = TokenType::Identifier;
+        } else if (kind == TokenKind::Number) {
+            types[i] = TokenType::Number;
+        } else if (kind < TokenKind::LParen) {
+            types[i] = TokenType::Operator;
+        } else if (kind < TokenKind::Const) {
+            types[i] = TokenType::Delimiter;
+        } else {
+            types[i] = TokenType::Keyword;
+        }
+    }
+    return types;
+}();
+
+constexpr TokenType toType(TokenKind kind)
+{
+    return TOKEN_KIND_TYPES[static_cast<size_t>(kind)];
+}
+
+constexpr TokenKind toKind(Keyword keyword)
+{
+    if (keyword == Keyword::None) {
+        return TokenKind::Nul;
+    }
+    return static_cast<TokenKind>(static_cast<uint8_t>(TokenKind::Const) +
+                                  static_cast<uint8_t>(keyword) - 1);
+}
+
+/**
+ * @return The keyword of a keyword kind, or Keyword::None for other kinds.
+ */
+constexpr Keyword toKeyword(TokenKind kind)
+{
+    if (kind < TokenKind::Const) {
+        return Keyword::None;
+    }
+    return static_cast<Keyword>(static_cast<uint8_t>(kind) -
+                                static_cast<uint8_t>(TokenKind::Const) + 1);
+}
+
+/**
+ * @brief The kind of each single-character operator or delimiter, indexed by the character.
+ */
+constexpr std::array<TokenKind, 256> SINGLE_CHAR_KINDS = [] {
+    std::array<TokenKind, 256> kinds{};
+    kinds['+'] = TokenKind::Plus;
+    kinds['-'] = TokenKind::Minus;
+    kinds['*'] = TokenKind::Times;
+    kinds['/'] = TokenKind::Slash;
+    kinds['='] = TokenKind::Eql;
+    kinds['#'] = TokenKind::Neq;
+    kinds['<'] = TokenKind::Lss;
+    kinds['>'] = TokenKind::Gtr;
+    kinds['('] = TokenKind::LParen;
+    kinds[')'] = TokenKind::RParen;
+    kinds[','] = TokenKind::Comma;
+    kinds[';'] = TokenKind::Semicolon;
+    kinds['.'] = TokenKind::Period;
+    return kinds;
+}();
+
+/**
+ * @return The kind of an operator or a delimiter, or TokenKind::Nul if the text is neither.
+ */
+constexpr TokenKind findPunctuationKind(std::string_view text)
+{
+    if (text.size() == 1) {
+        return SINGLE_CHAR_KINDS[static_cast<unsigned char>(text[0])];
+    }
+    if (text == "<=") {
+        return TokenKind::Leq;
+    } else if (text == ">=") {
+        return TokenKind::Geq;
+    } else if (text == ":=") {
+        return TokenKind::Becomes;
+    }
+    return TokenKind::Nul;
+}
+
+static_assert(toKind(Keyword::Read) == TokenKind::Read);
+static_assert(toKeyword(TokenKind::Const) == Keyword::Const);
+static_assert(toType(TokenKind::Becomes) == TokenType::Operator);
+static_assert(toType(TokenKind::Period) == TokenType::Delimiter);
+static_assert(findPunctuationKind(":=") == TokenKind::Becomes);
+static_assert(findPunctuationKind(":") == TokenKind::Nul);
+
+/**
+ * @note The value is a view into the source buffer which the token is scanned from.
+ *      It is only valid as long as the buffer is alive (see TokenList).
+ *      For keywords, the value is the lowercase spelling in KEYWORDS instead.
+ * @note The keyword is Keyword::None for all tokens except keywords.
+ * @note The kind tells the operator, delimiter or keyword apart without looking at the value.
+ * @note The id is the ID of an identifier in the Interner of the lexer, so identifiers can be
+ *      compared as integers. It is 0 for all other tokens.
+ * @note The offset is the position of the first character of the token in the source buffer.
+ *      It is 32-bit, so source files are limited to 4 GiB.
+ * @note The number is the value of a number token, decoded once by the lexer. It is 0 for all
+ *      other tokens. If the literal does not fit in int32_t, outOfRange is set and the number
+ *      is 0; the lexer reports it, and later stages must not use the value.
+ * @note The members are ordered to keep a token in 32 bytes. Construct tokens with designated
+ *      initializers, e.g. Token{.type = TokenType::Number, .value = "1"}.
+ */
 struct Token
 {
     TokenType type;
-    std::string value;
+    Keyword keyword = Keyword::None;
+    bool outOfRange = false;
+    TokenKind kind = TokenKind::Nul;
+    uint32_t id = 0;
+    std::string_view value;
+    uint32_t offset = 0;
+    int32_t number = 0;
+};
+
+static_assert(sizeof(Token) == 32);
+
+/**
+ * @brief Make a number token, and decode its value.
+ * @param value The digits of the number.
+ */
+inline Token makeNumberToken(std::string_view value)
+{
+    Token token{.type = TokenType::Number, .kind = TokenKind::Number, .value = value};
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), token.number);
+    token.outOfRange = error == std::errc::result_out_of_range;
+    return token;
+}
+
+/**
+ * @brief A sequence of tokens that keeps the source buffer of their values alive.
+ * @note Copying a TokenList shares the source buffer. Do not slice it into a plain
+ *      std::vector<Token> that outlives the list, otherwise the token values will dangle.
+ */
+class TokenList : public std::vector<Token>
+{
+public:
+    TokenList() = default;
+    explicit TokenList(std::shared_ptr<const SourceBuffer> source,
+                       std::shared_ptr<const Interner> interner = nullptr)
+        : m_source(std::move(source)), m_interner(std::move(interner))
+    {
+    }
+
+    /**
+     * @return The source buffer which the token values point into.
+     */
+    inline const std::shared_ptr<const SourceBuffer>& getSource() const
+    {
+        return m_source;
+    }
+
+    /**
+     * @return The table which the IDs of the identifiers refer to.
+     */
+    inline const std::shared_ptr<const Interner>& getInterner() const
+    {
+        return m_interner;
+    }
+
+private:
+    std::shared_ptr<const SourceBuffer> m_source;
+    std::shared_ptr<const Interner> m_interner;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
-// Constants
+// Token sources
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-constexpr std::array<std::string, 13> KEYWORDS = {"const", "var",   "procedure", "begin", "end",
-                                                  "if",    "then",  "while",     "do",    "call",
-                                                  "odd",   "write", "read"};
+/**
+ * @brief A lazy, single-pass sequence of tokens.
+ * @note It is an input range, so the tokens can be pulled one by one with next(), or iterated
+ *      with a range-based for loop. Each token can only be read once.
+ */
+class TokenSource
+{
+public:
+    /**
+     * @param source The source buffer which the token values point into, if it is known.
+     */
+    explicit TokenSource(std::shared_ptr<const SourceBuffer> source = nullptr)
+        : m_source(std::move(source))
+    {
+    }
+    virtual ~TokenSource() = default;
+
+    /**
+     * @return The source buffer which the token values point into, or nullptr if it is unknown.
+     * @note It is used to locate the tokens in diagnostics.
+     */
+    inline const std::shared_ptr<const SourceBuffer>& getSource() const
+    {
+        return m_source;
+    }
+
+    /**
+     * @brief Read the next token.
+     * @param token The token read.
+     * @return false if there are no more tokens, in which case {token} is left unchanged.
+     */
+    virtual bool next(Token& token) = 0;
+
+public:
+    class Iterator
+    {
+    public:
+        using value_type = Token;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        explicit Iterator(TokenSource* source) : m_source(source)
+        {
+            ++*this;
+        }
+
+        inline const Token& operator*() const
+        {
+            return m_token;
+        }
+
+        inline const Token* operator->() const
+        {
+            return &m_token;
+        }
+
+        inline Iterator& operator++()
+        {
+            if (!m_source->next(m_token)) {
+                m_source = nullptr;
+            }
+            return *this;
+        }
+
+        inline void operator++(int)
+        {
+            ++*this;
+        }
+
+        inline friend bool operator==(const Iterator& it, std::default_sentinel_t)
+        {
+            return it.m_source == nullptr;
+        }
+
+    private:
+        TokenSource* m_source = nullptr;
+        Token m_token{};
+    };
+
+    inline Iterator begin()
+    {
+        return Iterator(this);
+    }
+
+    inline std::default_sentinel_t end()
+    {
+        return std::default_sentinel;
+    }
+private:
+    std::shared_ptr<const SourceBuffer> m_source;
+};
+
+/**
+ * @brief A token source over tokens that have already been scanned.
+ */
+class TokenSpanSource : public TokenSource
+{
+public:
+    explicit TokenSpanSource(std::span<const Token> tokens,
+                             std::shared_ptr<const SourceBuffer> source = nullptr)
+        : TokenSource(std::move(source)), m_tokens(tokens)
+    {
+    }
+
+    bool next(Token& token) override
+    {
+        if (m_pos == m_tokens.size()) {
+            return false;
+        }
+        token = m_tokens[m_pos++];
+        return true;
+    }
+
+private:
+    std::span<const Token> m_tokens;
+    size_t m_pos = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Constants
+/////////////////////////////////////////////////////////////////////////////////////////////////
 
 constexpr std::array<char, 9> OPERATORS_CH = {'+', '-', '*', '/', '=', '#', '>', '<', ':'};
 
 constexpr std::array<char, 5> DELIMITERS = {'(', ')', ',', ';', '.'};
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Character classes
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief The class of a source character, as seen by the lexer.
+ * @note Operator characters are split into several classes, since '=' can be the second
+ *      character of <=, >= and :=, and ':' is only valid when followed by '='.
+ */
+enum class CharClass : uint8_t
+{
+    Other = 0,   // Characters that cannot begin any token.
+    Space,       // Characters accepted by std::isspace.
+    Alpha,       // a-z, A-Z
+    Digit,       // 0-9
+    Delimiter,   // ( ) , ; .
+    Operator,    // + - * / #
+    Equal,       // =
+    Relational,  // < >
+    Colon,       // :
+    LBrace,      // {
+    RBrace,      // }
+    End,         // EOF. The byte 0xFF is read as EOF as well.
+    Count
+};
+
+/**
+ * @brief The class of each byte.
+ * @note Classification follows the "C" locale, i.e. only ASCII letters are alphabets.
+ */
+constexpr std::array<CharClass, 256> CHAR_CLASSES = [] {
+    std::array<CharClass, 256> classes{};
+    for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Space;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        classes[c] = CharClass::Alpha;
+        classes[c - 'a' + 'A'] = CharClass::Alpha;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        classes[c] = CharClass::Digit;
+    }
+    for (char c : DELIMITERS) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Delimiter;
+    }
+    for (char c : OPERATORS_CH) {
+        classes[static_cast<unsigned char>(c)] = CharClass::Operator;
+    }
+    classes['='] = CharClass::Equal;
+    classes['<'] = CharClass::Relational;
+    classes['>'] = CharClass::Relational;
+    classes[':'] = CharClass::Colon;
+    classes['{'] = CharClass::LBrace;
+    classes['}'] = CharClass::RBrace;
+    classes[static_cast<unsigned char>(EOF)] = CharClass::End;
+    return classes;
+}();
+
+inline CharClass classify(char c)
+{
+    return CHAR_CLASSES[static_cast<unsigned char>(c)];
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Utility functions
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 inline bool isDigit(char c)
 {
-    return std::isdigit(c);
+    return classify(c) == CharClass::Digit;
 }
 
 inline bool isAlpha(char c)
 {
-    return std::isalpha(c);
+    return classify(c) == CharClass::Alpha;
 }
 
 inline bool isAlphaOrDigit(char c)
 {
-    return std::isalnum(c);
+    CharClass cls = classify(c);
+    return cls == CharClass::Alpha || cls == CharClass::Digit;
 }
 
 inline bool isDelimiter(char c)
 {
-    return std::ranges::find(DELIMITERS, c) != DELIMITERS.end();
+    return classify(c) == CharClass::Delimiter;
 }
 
 inline bool isOperatorChar(char c)
 {
-    return std::ranges::find(OPERATORS_CH, c) != OPERATORS_CH.end();
+    CharClass cls = classify(c);
+    return cls >= CharClass::Operator && cls <= CharClass::Colon;
 }
 }  // namespace PL0
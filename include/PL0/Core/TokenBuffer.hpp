@@ -0,0 +1,261 @@
+#pragma once
+#include "Token.hpp"
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief A sequence of tokens stored as a structure of arrays.
+ * @note Each token takes 13 bytes in four parallel arrays instead of 32 bytes in a Token:
+ *      - kind: the TokenKind, plus OUT_OF_RANGE for numbers that do not fit in int32_t
+ *      - offset and length: where the token is in the source buffer
+ *      - payload: the ID of an identifier in the interner, or the value of a number (0 for
+ *        other tokens)
+ *      Loops that only look at the kinds of the tokens read 1 byte per token, and no string is
+ *      stored per token.
+ * @note Tokens are rebuilt on access, so operator[] and the iterators return them by value.
+ *      The value of an identifier is a view into the interner, the value of a keyword is its
+ *      spelling in KEYWORDS, and the values of other tokens are views into the source buffer.
+ *      Both are kept alive by the buffer. Without an interner, identifiers are views into the
+ *      source buffer too.
+ */
+class TokenBuffer
+{
+public:
+    static constexpr uint8_t KIND_MASK = 0x3F;
+    static constexpr uint8_t OUT_OF_RANGE = 0x80;
+
+    TokenBuffer() = default;
+
+    /**
+     * @param source The source buffer which the tokens are scanned from.
+     * @param interner The table which the IDs of the identifiers refer to.
+     */
+    TokenBuffer(std::shared_ptr<const SourceBuffer> source,
+                std::shared_ptr<const Interner> interner);
+
+    /**
+     * @brief Store the tokens of a token list.
+     */
+    explicit TokenBuffer(const TokenList& tokens);
+
+    /**
+     * @brief Pull all the tokens of a token source, e.g. a TokenStream.
+     * @param tokens The token source. Its tokens are never materialized as a whole.
+     * @param interner The table which the IDs of the identifiers refer to.
+     */
+    TokenBuffer(TokenSource& tokens, std::shared_ptr<const Interner> interner);
+
+public:
+    /**
+     * @brief Append a token.
+     * @note The value of the token must be a view into the source buffer, unless the token is a
+     *      keyword or an identifier.
+     */
+    void push_back(const Token& token);
+
+    void reserve(size_t count);
+
+    inline size_t size() const noexcept
+    {
+        return m_kinds.size();
+    }
+
+    inline bool empty() const noexcept
+    {
+        return m_kinds.empty();
+    }
+
+    /**
+     * @return The token at {index}, rebuilt from the arrays.
+     */
+    Token operator[](size_t index) const;
+
+    inline TokenKind getKind(size_t index) const
+    {
+        return static_cast<TokenKind>(m_kinds[index] & KIND_MASK);
+    }
+
+    inline TokenType getType(size_t index) const
+    {
+        return toType(getKind(index));
+    }
+
+    inline uint32_t getOffset(size_t index) const
+    {
+        return m_offsets[index];
+    }
+
+    inline uint32_t getLength(size_t index) const
+    {
+        return m_lengths[index];
+    }
+
+    inline uint32_t getPayload(size_t index) const
+    {
+        return m_payloads[index];
+    }
+
+    /**
+     * @return The number of bytes held by the arrays.
+     */
+    size_t getMemoryUsage() const noexcept;
+
+    inline const std::shared_ptr<const SourceBuffer>& getSource() const
+    {
+        return m_source;
+    }
+
+    inline const std::shared_ptr<const Interner>& getInterner() const
+    {
+        return m_interner;
+    }
+
+public:
+    /**
+     * @brief A random-access iterator which rebuilds the tokens on dereference.
+     */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Token;
+        using difference_type = std::ptrdiff_t;
+        using reference = Token;
+
+        Iterator() = default;
+        Iterator(const TokenBuffer* buffer, size_t index) : m_buffer(buffer), m_index(index)
+        {
+        }
+
+        inline Token operator*() const
+        {
+            return (*m_buffer)[m_index];
+        }
+
+        inline Token operator[](difference_type n) const
+        {
+            return (*m_buffer)[m_index + n];
+        }
+
+        inline Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        inline Iterator operator++(int)
+        {
+            return {m_buffer, m_index++};
+        }
+
+        inline Iterator& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        inline Iterator operator--(int)
+        {
+            return {m_buffer, m_index--};
+        }
+
+        inline Iterator& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        inline Iterator& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        inline friend Iterator operator+(Iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        inline friend Iterator operator+(difference_type n, Iterator it)
+        {
+            return it += n;
+        }
+
+        inline friend Iterator operator-(Iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        inline friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+        {
+            return static_cast<difference_type>(lhs.m_index) -
+                   static_cast<difference_type>(rhs.m_index);
+        }
+
+        inline friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        inline friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index <=> rhs.m_index;
+        }
+
+    private:
+        const TokenBuffer* m_buffer = nullptr;
+        size_t m_index = 0;
+    };
+
+    inline Iterator begin() const
+    {
+        return {this, 0};
+    }
+
+    inline Iterator end() const
+    {
+        return {this, size()};
+    }
+
+private:
+    std::vector<uint8_t> m_kinds;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_lengths;
+    std::vector<uint32_t> m_payloads;
+
+    std::shared_ptr<const SourceBuffer> m_source;
+    std::shared_ptr<const Interner> m_interner;
+};
+
+static_assert(TOKEN_KIND_COUNT <= TokenBuffer::KIND_MASK + 1);
+static_assert(std::random_access_iterator<TokenBuffer::Iterator>);
+
+/**
+ * @brief A token source over a token buffer, so the parsers can run on it directly.
+ */
+class TokenBufferSource : public TokenSource
+{
+public:
+    explicit TokenBufferSource(const TokenBuffer& tokens)
+        : TokenSource(tokens.getSource()), m_tokens(tokens)
+    {
+    }
+
+    inline bool next(Token& token) override
+    {
+        if (m_index == m_tokens.size()) {
+            return false;
+        }
+        token = m_tokens[m_index++];
+        return true;
+    }
+
+private:
+    const TokenBuffer& m_tokens;
+    size_t m_index = 0;
+};
+}  // namespace PL0
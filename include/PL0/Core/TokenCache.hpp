@@ -0,0 +1,75 @@
+#pragma once
+#include "Token.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace PL0
+{
+/**
+ * @brief An on-disk cache of token lists, keyed by a hash of the source code.
+ * @note An entry is a compact binary file named after the hash:
+ *      a header, then the offsets, lengths and identifier IDs of the tokens (4 bytes each), the
+ *      offsets of the names in the string pool, the kinds of the tokens (1 byte each), and
+ *      finally the string pool of the distinct identifiers in lowercase.
+ * @note Entries are loaded through mmap (see SourceBuffer), and the arrays are read in place.
+ *      Loading allocates the token list once and interns each distinct identifier once; there
+ *      is no allocation per token.
+ * @note Numbers, operators, delimiters and invalid tokens are views into the source buffer,
+ *      whose text is unchanged by a cache hit. Only the identifiers, which the lexer would have
+ *      converted to lowercase in place, are taken from the string pool, so a hit never writes
+ *      to the buffer and its pages stay shared with the page cache.
+ * @note An entry has no checksum: it is only used if it matches the size and the hash of the
+ *      source, and if every token and name lies within the source and the entry, so a corrupt
+ *      entry is rejected or gives wrong tokens, but never reads out of bounds.
+ * @note Entries use the byte order of the machine, and are rejected by a machine with another one.
+ */
+class TokenCache
+{
+public:
+    /**
+     * @param directory The directory of the entries. It is created when the first entry is stored.
+     */
+    explicit TokenCache(std::filesystem::path directory);
+
+    /**
+     * @brief Hash the source code to get the key of its entry.
+     * @note It must be called before the source is lexed, since lexing changes the identifiers
+     *      in the buffer to lowercase.
+     */
+    static uint64_t hash(std::string_view text) noexcept;
+
+    /**
+     * @brief Load the tokens of a source from its entry.
+     * @param key The hash of the source.
+     * @param source The source, which the values of the tokens will point into.
+     * @param interner The table to intern the identifiers in.
+     * @return The tokens, or std::nullopt if there is no valid entry.
+     * @note An entry is valid if its header matches the source and the size of the entry, and
+     *      every token lies in the source. The whole entry is checked before the first
+     *      identifier is interned, so an invalid entry leaves the interner unchanged.
+     *      Diagnostics are not reported, since the cache stores none.
+     */
+    std::optional<TokenList> load(uint64_t key, std::shared_ptr<const SourceBuffer> source,
+                                  const std::shared_ptr<Interner>& interner) const;
+
+    /**
+     * @brief Store the tokens of a source as its entry.
+     * @param key The hash of the source, taken before it was lexed.
+     * @param tokens The tokens of the source.
+     * @note The entry is written to a temporary file and renamed, so a concurrent reader never
+     *      sees half an entry. Failures are ignored, since the cache is only an optimization.
+     */
+    void store(uint64_t key, const TokenList& tokens) const;
+
+    /**
+     * @return The path of the entry of a key.
+     */
+    std::filesystem::path getPath(uint64_t key) const;
+
+private:
+    std::filesystem::path m_directory;
+};
+}  // namespace PL0
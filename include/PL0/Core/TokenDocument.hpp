@@ -0,0 +1,122 @@
+#pragma once
+#include "Token.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief The source and the tokens of a file which is edited over time, e.g. in an editor.
+ * @note The source is split into segments of about SEGMENT_SIZE bytes, each of which holds its
+ *      own text and the tokens scanned from it. A segment always begins where a token begins
+ *      (or at the beginning of the file), so it can be lexed from the start state of the DFA.
+ * @note The offsets of the tokens are relative to their segment, and their values are views into
+ *      the text of their segment. An edit (see Lexer::relex()) only rebuilds the segments it
+ *      damages, and the tokens of the other segments are neither copied nor rebased. Only the
+ *      starts of the later segments are shifted, which is one addition per segment.
+ * @note A segment is only split where a token begins, so a long comment, or the text after EOF,
+ *      stays in one segment, and an edit in it copies the whole segment.
+ */
+class TokenDocument
+{
+public:
+    static constexpr size_t SEGMENT_SIZE = size_t(32) << 10;
+
+    /**
+     * @brief Split the source and the tokens of a token list into segments.
+     * @param tokens The tokens of the whole source, e.g. from Lexer::tokenize(). Without a
+     *      source buffer, the source is empty.
+     * @param interner The table which the IDs of the tokens refer to, e.g. the one given to
+     *      Lexer::tokenize(). Lexer::relex() interns the new identifiers in it.
+     * @throw std::invalid_argument If {interner} is null, or the tokens refer to another table.
+     * @note It copies the source once, so it takes time proportional to the file. Identifiers
+     *      are converted to lowercase in the copy, since tokens from the token cache leave them
+     *      in their original case in the source.
+     */
+    TokenDocument(const TokenList& tokens, std::shared_ptr<Interner> interner);
+
+public:
+    /**
+     * @return The size of the source in bytes.
+     */
+    inline size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    /**
+     * @return The number of tokens.
+     */
+    inline size_t getTokenCount() const noexcept
+    {
+        return m_tokenCount;
+    }
+
+    /**
+     * @return The number of segments.
+     */
+    inline size_t getSegmentCount() const noexcept
+    {
+        return m_segments.size();
+    }
+
+    /**
+     * @return The table which the IDs of the identifiers refer to.
+     */
+    inline const std::shared_ptr<Interner>& getInterner() const
+    {
+        return m_interner;
+    }
+
+    /**
+     * @brief Get the line and column of a byte of the source.
+     * @param offset The offset of the byte. The size of the source stands for the end of it.
+     * @note It counts the lines of the segments before the byte, so it is meant for diagnostics.
+     */
+    SourceLocation getLocation(size_t offset) const;
+
+    /**
+     * @brief Copy the source and the tokens into a token list, e.g. to parse the whole file.
+     * @note It takes time proportional to the file.
+     */
+    TokenList toTokenList() const;
+
+private:
+    friend class Lexer;
+
+    /**
+     * @brief A part of the source and the tokens scanned from it.
+     */
+    struct Segment
+    {
+        size_t start = 0;                    // The offset of the segment in the source.
+        std::shared_ptr<SourceBuffer> text;  // The text, which the token values point into.
+        std::vector<Token> tokens = {};      // The offsets are relative to the segment.
+        uint32_t lineBreaks = 0;             // The number of '\n' in the text.
+    };
+
+    /**
+     * @brief Split a text and its tokens into segments of about SEGMENT_SIZE bytes.
+     * @param text The text, which begins where a token begins.
+     * @param tokens The tokens of the text. Their offsets are relative to the text, and their
+     *      values may point anywhere.
+     * @param start The offset of the text in the source.
+     * @return The segments, whose token values point into their own text.
+     */
+    static std::vector<Segment> split(std::string_view text, std::vector<Token>&& tokens,
+                                      size_t start);
+
+    /**
+     * @return The index of the segment which contains the byte at {offset}. The size of the
+     *      source belongs to the last segment.
+     */
+    size_t findSegment(size_t offset) const;
+
+private:
+    std::vector<Segment> m_segments;  // There is always one segment, even for an empty source.
+    size_t m_size = 0;
+    size_t m_tokenCount = 0;
+    std::shared_ptr<Interner> m_interner;
+};
+}  // namespace PL0
@@ -0,0 +1,137 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace PL0
+{
+/**
+ * @brief A bump allocator of objects identified by dense 32-bit indices.
+ * @note The objects are stored in chunks whose sizes double: chunk c holds the indices
+ *      [BASE * (2^c - 1), BASE * (2^(c + 1) - 1)). An object never moves once allocated, and
+ *      locating one by its index takes a few bit operations.
+ * @note The objects must be trivially destructible, so they are never visited when they are
+ *      freed. 32-bit indices need at most 25 chunks, so clearing or destroying an arena is O(1)
+ *      whatever the number of objects. Clearing keeps the chunks for reuse.
+ * @note Not thread-safe.
+ */
+template <typename T>
+class Arena
+{
+    static_assert(std::is_trivially_destructible_v<T>);
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    static constexpr uint32_t BASE = 256;  // The number of objects in the first chunk.
+
+    Arena() = default;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+public:
+    /**
+     * @brief Allocate a copy of {value}.
+     * @return The index of the new object.
+     */
+    inline uint32_t push(const T& value)
+    {
+        if (m_size == m_capacity) {
+            grow();
+        }
+        m_tail[m_size - m_tailBegin] = value;
+        return m_size++;
+    }
+
+    /**
+     * @note The objects allocated last, which are accessed the most while a structure is built,
+     *      are found in the tail chunk without locating the chunk.
+     */
+    inline T& operator[](uint32_t index)
+    {
+        if (index >= m_tailBegin) {
+            return m_tail[index - m_tailBegin];
+        }
+        auto [chunk, slot] = locate(index);
+        return m_chunks[chunk][slot];
+    }
+
+    inline const T& operator[](uint32_t index) const
+    {
+        auto [chunk, slot] = locate(index);
+        return m_chunks[chunk][slot];
+    }
+
+    /**
+     * @return The number of objects allocated, which is also the index of the next one.
+     */
+    inline uint32_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Free all the objects at once. The chunks are kept for the next objects.
+     */
+    inline void clear()
+    {
+        m_size = 0;
+        m_tailBegin = 0;
+        m_tail = m_chunks[0].get();
+        m_capacity = m_chunks[0] ? BASE : 0;
+    }
+
+    /**
+     * @return The number of bytes of the chunks allocated.
+     */
+    size_t getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        for (size_t chunk = 0; chunk < m_chunks.size() && m_chunks[chunk]; ++chunk) {
+            bytes += getChunkSize(chunk) * sizeof(T);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr size_t getChunkSize(size_t chunk)
+    {
+        return size_t(BASE) << chunk;
+    }
+
+    static constexpr size_t getChunkBegin(size_t chunk)
+    {
+        return BASE * ((size_t(1) << chunk) - 1);
+    }
+
+    static inline std::pair<size_t, size_t> locate(uint32_t index)
+    {
+        size_t chunk = std::bit_width(index / BASE + 1) - 1;
+        return {chunk, index - getChunkBegin(chunk)};
+    }
+
+    /**
+     * @brief Move the tail to the next chunk, which is allocated if it is not kept yet.
+     */
+    void grow()
+    {
+        size_t chunk = locate(m_size).first;
+        if (!m_chunks[chunk]) {
+            m_chunks[chunk] = std::make_unique_for_overwrite<T[]>(getChunkSize(chunk));
+        }
+        m_tail = m_chunks[chunk].get();
+        m_tailBegin = m_size;
+        m_capacity = getChunkBegin(chunk + 1);
+    }
+
+private:
+    std::array<std::unique_ptr<T[]>, 25> m_chunks;
+    T* m_tail = nullptr;       // The chunk which the next object is allocated in.
+    uint32_t m_tailBegin = 0;  // The index of the first object of the tail chunk.
+    size_t m_capacity = 0;     // The index after the last object of the tail chunk.
+    uint32_t m_size = 0;
+};
+}  // namespace PL0
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <format>
 #include <string_view>
 #include <unordered_map>
@@ -29,6 +30,9 @@ public:
         std::stringstream ss;
         ss << it->second.value.value();
         T value;
+        if constexpr (std::is_same_v<T, bool>) {
+            ss >> std::boolalpha;  // "true" or "false", as checked by addOption
+        }
         ss >> value;
         if (ss.fail()) {
             std::cout << std::format("Failed to convert {} to type {}", it->second.value.value(),
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief Collect the files of a batch.
+ * @param input A directory, whose regular files are taken in the order of their paths, or a
+ *      manifest file, which lists one path per line. Blank lines and lines beginning with '#'
+ *      are skipped, and relative paths are relative to the directory of the manifest.
+ * @return The paths of the files.
+ * @throw std::runtime_error If the input cannot be read.
+ */
+std::vector<std::string> listBatchFiles(const std::string& input);
+
+/**
+ * @brief Decide where the output of each file of a batch is written.
+ * @param files The files of the batch.
+ * @param outputDir The directory of the outputs, which is created if it does not exist.
+ * @return The path of the output of each file, which has the same name as the file.
+ * @throw std::runtime_error If two files have the same name, an output would be written over a
+ *      file of the batch, e.g. if the directory is the one of the files, or the directory cannot
+ *      be created.
+ */
+std::vector<std::string> getBatchOutputPaths(const std::vector<std::string>& files,
+                                             const std::string& outputDir);
+
+/**
+ * @brief Process the files of a batch on a work-stealing thread pool.
+ * @param files The files of the batch.
+ * @param threadCount The number of threads, or 0 for one per hardware thread.
+ * @param process The work on the file at an index. It is called on several threads at once, so
+ *      the state it shares must be read-only, e.g. a parser.
+ * @return The number of files whose work threw an exception.
+ * @note For each file, "Source file: <file>" is printed, followed by the messages reported (see
+ *      Reporter) while it is processed, and by the exception it throws as an error. The files
+ *      are printed in order as soon as the files before them are done, so the output is the same
+ *      whatever the number of threads is.
+ */
+size_t runBatch(const std::vector<std::string>& files, size_t threadCount,
+                const std::function<void(size_t)>& process);
+}  // namespace PL0
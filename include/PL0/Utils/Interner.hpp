@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace PL0
+{
+/**
+ * @brief A table of distinct strings, each of which is identified by a dense 32-bit ID.
+ * @note IDs are assigned in the order the strings are first interned, starting from 0.
+ *      Comparing two interned strings is comparing two integers.
+ * @note Not thread-safe. Threads that intern concurrently should use their own tables and merge
+ *      them afterwards.
+ */
+class Interner
+{
+public:
+    Interner() = default;
+
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+public:
+    /**
+     * @return The ID of the string. A new ID is assigned if the string is not interned yet.
+     */
+    uint32_t intern(std::string_view str);
+
+    /**
+     * @return The ID of the string, or std::nullopt if the string is not interned.
+     */
+    std::optional<uint32_t> find(std::string_view str) const;
+
+    /**
+     * @return The string identified by {id}.
+     * @note The view stays valid as long as the table is alive.
+     */
+    inline std::string_view getString(uint32_t id) const
+    {
+        return m_strings[id];
+    }
+
+    /**
+     * @return The number of distinct strings, which is also the next ID to be assigned.
+     */
+    inline size_t size() const
+    {
+        return m_strings.size();
+    }
+
+private:
+    std::deque<std::string> m_strings;  // The elements never move, so the keys stay valid.
+    std::unordered_map<std::string_view, uint32_t> m_ids;
+};
+}  // namespace PL0
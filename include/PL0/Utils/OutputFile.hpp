@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace PL0
+{
+/**
+ * @brief A write-only file with a large, reusable output buffer.
+ * @note Small writes are appended to the buffer, which is written to the file in one call once it
+ *      is full. A write that does not fit in the rest of the buffer is written together with the
+ *      buffer in one vectored call, without copying it first.
+ * @note On Linux, the file is written with write(2) and writev(2). On other platforms, it is
+ *      written through a std::ofstream in text mode, so the bytes are the same as those written
+ *      by a std::ofstream on that platform.
+ */
+class OutputFile
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 20;
+
+    /**
+     * @param filename The path to the file, which is created or truncated.
+     * @param capacity The size of the output buffer in bytes.
+     * @throw std::runtime_error If the file cannot be opened.
+     */
+    explicit OutputFile(const std::string& filename, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Flush the buffer and close the file.
+     * @note Errors are ignored here. Call close() to have them reported.
+     */
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+public:
+    inline void write(char c)
+    {
+        if (m_buffer.size() == m_capacity) {
+            flush();
+        }
+        m_buffer.push_back(c);
+    }
+
+    inline void write(std::string_view str)
+    {
+        if (str.size() <= m_capacity - m_buffer.size()) {
+            m_buffer.append(str);
+        } else {
+            writeThrough(str);
+        }
+    }
+
+    /**
+     * @brief Write an integer in decimal.
+     */
+    void writeNumber(int64_t value);
+
+    /**
+     * @brief Write the buffered bytes to the file.
+     * @throw std::runtime_error If the bytes cannot be written.
+     */
+    void flush();
+
+    /**
+     * @brief Flush the buffer and close the file.
+     * @throw std::runtime_error If the bytes cannot be written.
+     */
+    void close();
+
+private:
+    /**
+     * @brief Write the buffered bytes and then {str} to the file.
+     */
+    void writeThrough(std::string_view str);
+
+private:
+    std::string m_filename;
+    size_t m_capacity;
+    std::string m_buffer;
+#ifdef __linux__
+    int m_fd = -1;
+#else
+    std::ofstream m_stream;
+#endif
+};
+}  // namespace PL0
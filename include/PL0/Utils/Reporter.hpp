@@ -10,17 +10,51 @@ class Reporter
 public:
     static void info(const std::string& message)
     {
-        std::cout << std::format("{}INFO >>> {}\n{}", m_infoColor, message, m_resetColor);
+        *getStream() << std::format("{}INFO >>> {}\n{}", m_infoColor, message, m_resetColor);
     }
 
     static void success(const std::string& message)
     {
-        std::cout << std::format("{}SUCCESS >>> {}\n{}", m_successColor, message, m_resetColor);
+        *getStream() << std::format("{}SUCCESS >>> {}\n{}", m_successColor, message, m_resetColor);
     }
 
     static void error(const std::string& message)
     {
-        std::cout << std::format("{}ERROR >>> {}\n{}", m_errorColor, message, m_resetColor);
+        *getStream() << std::format("{}ERROR >>> {}\n{}", m_errorColor, message, m_resetColor);
+    }
+
+    /**
+     * @brief Redirect the messages reported on the current thread to a stream while alive.
+     * @note A worker of a batch collects the diagnostics of its file this way, so they can be
+     *      printed in the order of the files rather than the order they are reported.
+     */
+    class Redirect
+    {
+    public:
+        explicit Redirect(std::ostream& stream) : m_previous(getStream())
+        {
+            getStream() = &stream;
+        }
+        ~Redirect()
+        {
+            getStream() = m_previous;
+        }
+
+        Redirect(const Redirect&) = delete;
+        Redirect& operator=(const Redirect&) = delete;
+
+    private:
+        std::ostream* m_previous;
+    };
+
+private:
+    /**
+     * @return The stream which the messages of the current thread are written to.
+     */
+    static std::ostream*& getStream()
+    {
+        thread_local std::ostream* stream = &std::cout;
+        return stream;
     }
 
 private:
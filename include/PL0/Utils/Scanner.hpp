@@ -1,12 +1,17 @@
 #pragma once
-#include <fstream>
-#include <functional>
+#include "SourceBuffer.hpp"
+#include <cstdio>
+#include <memory>
 #include <string>
+#include <string_view>
 
 namespace PL0
 {
 /**
  * @brief A character scanner for reading the PL/0 source file.
+ * @note The whole source is held in a SourceBuffer, so the strings returned by the scanner are
+ *      views into the buffer instead of copies. The buffer may hold a mapped file, a file or pipe
+ *      read into memory, or text which is already in memory (see SourceBuffer).
  */
 class Scanner
 {
@@ -17,15 +22,20 @@ public:
      * @note The cursor will be set to the first character.
      */
     Scanner(const std::string& filename);
-    ~Scanner();
+
+    /**
+     * @param source The source buffer to scan.
+     * @note The cursor will be set to the first character.
+     */
+    Scanner(std::shared_ptr<SourceBuffer> source);
 
 public:
     /**
-     * @return The current character.
+     * @return The current character, or EOF if all characters have been scanned.
      */
     inline char get() const
     {
-        return m_curChar;
+        return m_cur != m_end ? *m_cur : EOF;
     }
 
     /**
@@ -33,28 +43,78 @@ public:
      */
     inline std::string getAsStr() const
     {
-        return std::string(1, m_curChar);
+        return std::string(1, get());
+    }
+
+    /**
+     * @return The current character as a view into the source buffer.
+     */
+    inline std::string_view getAsView() const
+    {
+        return {m_cur, m_cur != m_end ? 1u : 0u};
     }
 
     /**
      * @brief Get the characters until the function {fn} returns false.
      * @param fn The function to determine whether to continue reading.
-     * @return The characters read.
+     * @return The characters read, as a view into the source buffer.
      * @note {fn} will not determine the first character.
+     * @note {fn} is a template parameter rather than a std::function, so it is inlined into the
+     *      loop instead of being called indirectly for every character.
      */
-    std::string getUntil(std::function<bool(char)> fn);
+    template <typename Predicate>
+    inline std::string_view getUntil(Predicate fn)
+    {
+        const char* begin = m_cur;
+
+        do {
+            forward();
+        } while (fn(get()));
+
+        return {begin, static_cast<size_t>(m_cur - begin)};
+    }
+
+    /**
+     * @brief Convert the characters of a view returned by this scanner to lowercase in place.
+     * @param str A view into the source buffer.
+     * @note Only the in-memory copy is modified, never the file itself.
+     */
+    void toLower(std::string_view str);
 
     /**
      * @brief Skip the spaces and comments, and stop at the first available character.
      */
     void skipSpaceAndComments();
+
     /**
      * @brief Move the cursor to the next character.
      */
-    void forward();
+    inline void forward()
+    {
+        if (m_cur != m_end) {
+            ++m_cur;
+        }
+    }
+
+    /**
+     * @return The offset of the current character in the source buffer.
+     */
+    inline size_t getOffset() const
+    {
+        return m_cur - m_source->data();
+    }
+
+    /**
+     * @return The source buffer being scanned.
+     */
+    inline const std::shared_ptr<SourceBuffer>& getSource() const
+    {
+        return m_source;
+    }
 
 private:
-    std::ifstream m_file;
-    char m_curChar = EOF;
+    std::shared_ptr<SourceBuffer> m_source;
+    char* m_cur = nullptr;  // The current character.
+    char* m_end = nullptr;  // The next position after the last character.
 };
 }  // namespace PL0
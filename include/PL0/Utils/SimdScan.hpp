@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+
+namespace PL0
+{
+/**
+ * @brief The instruction sets that can be used to scan runs of characters.
+ */
+enum class SimdLevel : uint8_t
+{
+    Scalar = 0,  // One byte at a time.
+    SSE2,        // 16 bytes at a time.
+    AVX2         // 32 bytes at a time.
+};
+
+/**
+ * @return The best level supported by the CPU.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @return The level used by skipSpaces() and findCommentEnd().
+ * @note It is detectSimdLevel() by default.
+ */
+SimdLevel getSimdLevel();
+
+/**
+ * @brief Select the level used by skipSpaces() and findCommentEnd().
+ * @note Levels that the CPU does not support are lowered to the best supported one.
+ * @warning Not thread-safe. It is meant for benchmarks and tests.
+ */
+void setSimdLevel(SimdLevel level);
+
+namespace detail
+{
+const char* skipSpacesImpl(const char* cur, const char* end);
+const char* findCommentEndImpl(const char* cur, const char* end);
+}  // namespace detail
+
+/**
+ * @return Whether the character is accepted by std::isspace in the "C" locale.
+ */
+inline bool isSpaceChar(char c)
+{
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+/**
+ * @brief Skip the spaces in [cur, end).
+ * @return The first non-space character, or end.
+ * @note The first two characters are checked inline, since most runs of spaces are a single
+ *      space between two tokens, which is not worth a SIMD scan.
+ */
+inline const char* skipSpaces(const char* cur, const char* end)
+{
+    for (int i = 0; i < 2; ++i, ++cur) {
+        if (cur == end || !isSpaceChar(*cur)) {
+            return cur;
+        }
+    }
+    return detail::skipSpacesImpl(cur, end);
+}
+
+/**
+ * @brief Find the end of a comment in [cur, end).
+ * @return The first '}' or EOF (the byte 0xFF), or end.
+ */
+inline const char* findCommentEnd(const char* cur, const char* end)
+{
+    return detail::findCommentEndImpl(cur, end);
+}
+}  // namespace PL0
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief A position in a source file. Both the line and the column start from 1.
+ * @note The column counts bytes, and a tab counts as one.
+ */
+struct SourceLocation
+{
+    uint32_t line;
+    uint32_t column;
+
+    /**
+     * @return "line:column"
+     */
+    inline std::string toString() const
+    {
+        return std::format("{}:{}", line, column);
+    }
+};
+
+/**
+ * @brief The whole content of a PL/0 source file held in memory.
+ * @note On Linux, the file is mapped with mmap as a private (copy-on-write) mapping.
+ *      On other platforms, or if the file cannot be mapped (e.g. a pipe), the file is read into
+ *      an owned buffer instead.
+ * @note The buffer is writable, but writes never reach the file on disk.
+ */
+class SourceBuffer
+{
+public:
+    /**
+     * @brief The largest source, since the tokens keep 32-bit offsets into it.
+     */
+    static constexpr size_t MAX_SIZE = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @param filename The path to the PL/0 source file.
+     * @throw std::runtime_error If the file cannot be opened, or it is larger than MAX_SIZE.
+     */
+    explicit SourceBuffer(const std::string& filename);
+    ~SourceBuffer();
+
+    /**
+     * @brief Create a source buffer that holds the given text instead of a file.
+     * @param text The PL/0 source code.
+     * @throw std::runtime_error If the text is larger than MAX_SIZE.
+     */
+    static std::shared_ptr<SourceBuffer> fromText(std::string text);
+
+    /**
+     * @brief Create a source buffer that holds everything read from a stream, e.g. std::cin.
+     * @param stream The stream, which is read until its end.
+     * @throw std::runtime_error If the stream holds more than MAX_SIZE bytes.
+     */
+    static std::shared_ptr<SourceBuffer> fromStream(std::istream& stream);
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+public:
+    inline char* data() noexcept
+    {
+        return m_data;
+    }
+
+    inline const char* data() const noexcept
+    {
+        return m_data;
+    }
+
+    inline size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    inline std::string_view view() const noexcept
+    {
+        return {m_data, m_size};
+    }
+
+    /**
+     * @return Whether the file is memory-mapped (rather than read into an owned buffer).
+     */
+    inline bool isMapped() const noexcept
+    {
+        return m_mapped;
+    }
+
+    /**
+     * @brief Convert the characters of a view into this buffer to lowercase in place.
+     * @param str A view into this buffer.
+     * @note Only the in-memory copy is modified, never the file itself.
+     */
+    void toLower(std::string_view str);
+
+    /**
+     * @brief Get the line and column of a byte.
+     * @param offset The offset of the byte. The size of the buffer stands for the end of it.
+     * @note The line table is built on the first call, which scans the whole buffer once.
+     *      The error-free path never pays for it. Later calls are binary searches.
+     * @note Thread-safe.
+     */
+    SourceLocation getLocation(size_t offset) const;
+
+private:
+    SourceBuffer() = default;
+
+    void readWholeFile(const std::string& filename);
+
+    /**
+     * @throw std::runtime_error If {size} is larger than MAX_SIZE.
+     */
+    static void checkSize(size_t size, const std::string& name);
+
+private:
+    char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::string m_owned;  // Storage for the fallback path.
+
+    mutable std::once_flag m_lineStartsBuilt;
+    mutable std::vector<uint32_t> m_lineStarts;  // The offset of the first byte of each line.
+};
+}  // namespace PL0
@@ -1,24 +1,23 @@
 #pragma once
-#include <string>
+#include <charconv>
 #include <optional>
-#include <stdexcept>
+#include <string_view>
 
 namespace PL0
 {
 /**
  * @brief Convert a string to an integer.
  * @param str The string that may represent a number.
- * @return The number if the string is a number; otherwise, std::nullopt.
+ * @return The number if the whole string is a number in the range of int; otherwise, std::nullopt.
+ * @note std::from_chars neither allocates nor throws, so a failed conversion costs nothing.
  */
-std::optional<int> str2num(const std::string& str)
+inline std::optional<int> str2num(std::string_view str)
 {
-    try {
-        int num = std::stoi(str);
-        return std::make_optional(num);
-    } catch (const std::invalid_argument& e) {
+    int num = 0;
+    auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), num);
+    if (error != std::errc() || end != str.data() + str.size()) {
         return std::nullopt;
     }
+    return num;
 }
-    
-} // namespace PL0
-
+}  // namespace PL0
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PL0
+{
+/**
+ * @brief A fixed set of worker threads which run submitted tasks, balanced by work stealing.
+ * @note Each worker has its own queue. A worker runs the newest task of its own queue first, and
+ *      when its queue is empty, it steals the oldest task of another queue. So workers rarely
+ *      contend for the same queue, and a worker that gets long tasks does not hold up the rest.
+ * @note Tasks submitted by a worker go to the queue of that worker. Other tasks are spread over
+ *      the queues in turn.
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threadCount The number of workers, or 0 for one per hardware thread.
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Wait for all the tasks, and stop the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    void submit(Task task);
+
+    /**
+     * @brief Wait until all the tasks submitted so far have finished.
+     * @throw The first exception thrown by a task since the last call, if any.
+     * @note It must not be called by a task, which would wait for itself.
+     */
+    void wait();
+
+    /**
+     * @brief Run {fn}(i) for i in [0, count) on the workers, and wait for all of them.
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            submit([fn, i] { fn(i); });
+        }
+        wait();
+    }
+
+    inline size_t getThreadCount() const
+    {
+        return m_workers.size();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+
+    /**
+     * @brief Take a task from the queue of worker {index}, or steal one from another queue.
+     * @return Whether a task is taken.
+     */
+    bool take(size_t index, Task& task);
+
+private:
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_nextQueue = 0;  // The queue of the next task submitted from outside.
+
+    std::mutex m_mutex;  // Guards the counters below and the exception.
+    std::condition_variable m_taskReady;
+    std::condition_variable m_allDone;
+    size_t m_queuedCount = 0;   // The number of tasks in the queues.
+    size_t m_pendingCount = 0;  // The number of tasks that have not finished.
+    bool m_stopping = false;
+    std::exception_ptr m_exception;
+};
+}  // namespace PL0
@@ -2,13 +2,14 @@
 #include "PL0/Utils/Error.hpp"
 #include "PL0/Utils/Reporter.hpp"
 #include <format>
+#include <utility>
 
 namespace PL0
 {
 
 namespace Action
 {
-int print(const std::vector<int>& operands)
+int print(std::span<const int> operands)
 {
     if (operands.empty()) {
         throw SemanticError("No operand to print.");
@@ -21,7 +22,7 @@ int print(const std::vector<int>& operands)
     return ans;
 }
 
-int assign(const std::vector<int>& operands)
+int assign(std::span<const int> operands)
 {
     if (operands.empty()) {
         throw SemanticError("No operand for assignment.");
@@ -32,7 +33,7 @@ int assign(const std::vector<int>& operands)
     return operands[0];
 }
 
-int opposite(const std::vector<int>& operands)
+int opposite(std::span<const int> operands)
 {
     if (operands.empty()) {
         throw SemanticError("No operand for opposite.");
@@ -43,7 +44,7 @@ int opposite(const std::vector<int>& operands)
     return -operands[0];
 }
 
-int add(const std::vector<int>& operands)
+int add(std::span<const int> operands)
 {
     if (operands.size() < 2) {
         throw SemanticError("Too few operands for addition.");
@@ -55,7 +56,7 @@ int add(const std::vector<int>& operands)
     return operands[0] + operands[1];
 }
 
-int sub(const std::vector<int>& operands)
+int sub(std::span<const int> operands)
 {
     if (operands.size() < 2) {
         throw SemanticError("Too few operands for subtraction.");
@@ -66,7 +67,7 @@ int sub(const std::vector<int>& operands)
     return operands[0] - operands[1];
 }
 
-int mul(const std::vector<int>& operands)
+int mul(std::span<const int> operands)
 {
     if (operands.size() < 2) {
         throw SemanticError("Too few operands for multiplication.");
@@ -77,7 +78,7 @@ int mul(const std::vector<int>& operands)
     return operands[0] * operands[1];
 }
 
-int div(const std::vector<int>& operands)
+int div(std::span<const int> operands)
 {
     if (operands.size() < 2) {
         throw SemanticError("Too few operands for division.");
@@ -90,6 +91,20 @@ int div(const std::vector<int>& operands)
     }
     return operands[0] / operands[1];
 }
+
+Function find(std::string_view name)
+{
+    constexpr std::pair<std::string_view, Function> FUNCTIONS[] = {
+        {"print", print}, {"assign", assign}, {"opposite", opposite}, {"add", add},
+        {"sub", sub},     {"mul", mul},       {"div", div},
+    };
+    for (const auto& [functionName, function] : FUNCTIONS) {
+        if (functionName == name) {
+            return function;
+        }
+    }
+    return nullptr;
+}
 }  // namespace Action
 
 }  // namespace PL0
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "PL0/Core/Ast.hpp"
+#include "PL0/Core/Symbol.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PL0
+{
+void CompilationUnit::reset(std::shared_ptr<const SourceBuffer> source)
+{
+    m_nodes.clear();
+    m_root = NO_NODE;
+    m_source = std::move(source);
+}
+
+void CompilationUnit::print(std::ostream& os) const
+{
+    if (m_root == NO_NODE) {
+        return;
+    }
+
+    /**
+     * @note The nodes are visited in preorder with a stack on the heap rather than by recursion,
+     *      so a deep tree, e.g. the left-deep tree of a long sum, cannot overflow the call stack.
+     *      The children are pushed from the last one, so the first one is printed first.
+     */
+    std::vector<std::pair<NodeId, size_t>> pending = {{m_root, 0}};
+    while (!pending.empty()) {
+        auto [id, depth] = pending.back();
+        pending.pop_back();
+        printNode(os, id, depth);
+        for (NodeId child = getLastChild(id); child != NO_NODE; child = getPrevSibling(id, child)) {
+            pending.push_back({child, depth + 1});
+        }
+    }
+}
+
+void CompilationUnit::getChildren(NodeId id, std::vector<NodeId>& children) const
+{
+    children.clear();
+    for (NodeId child = getLastChild(id); child != NO_NODE; child = getPrevSibling(id, child)) {
+        children.push_back(child);
+    }
+    std::ranges::reverse(children);
+}
+
+void CompilationUnit::printNode(std::ostream& os, NodeId id, size_t depth) const
+{
+    const Node& node = m_nodes[id];
+    os << std::string(depth * 2, ' ') << NODE_KIND_NAMES[static_cast<size_t>(node.kind)];
+    if (node.kind == NodeKind::Number) {
+        os << " " << static_cast<int32_t>(node.payload);
+    } else if (node.kind != NodeKind::Empty && isLeaf(node.kind)) {
+        if (m_source) {
+            std::string_view rest = m_source->view().substr(node.offset);
+            auto end = std::ranges::find_if_not(
+                rest, [](unsigned char c) { return std::isalnum(c) != 0; });
+            os << " " << rest.substr(0, end - rest.begin());
+        } else {
+            os << " #" << node.payload;
+        }
+    }
+    os << "\n";
+}
+
+void ExpressionBuilder::pushInvalid(const Token& token)
+{
+    std::string_view symbol = translateExpressionSymbol(token);
+    TokenKind kind = findPunctuationKind(symbol);
+    if (symbol == "num") {
+        pushOperand(NodeKind::Number, token.offset, static_cast<uint32_t>(getNumberValue(token)));
+    } else if (symbol == "id") {
+        push(TokenKind::Ident, token);
+    } else if (kind != TokenKind::Nul) {
+        push(kind, token);
+    } else {
+        m_valid = false;
+    }
+}
+
+NodeId ExpressionBuilder::finish()
+{
+    reduce(1);
+    NodeId root = m_valid && m_operators.empty() && m_operandCount == 1
+                      ? m_unit.getNodeCount() - 1
+                      : NO_NODE;
+    m_operators.clear();
+    m_operandCount = 0;
+    m_expectOperand = true;
+    m_valid = true;
+    return root;
+}
+}  // namespace PL0
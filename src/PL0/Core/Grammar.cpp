@@ -0,0 +1,527 @@
+#include "PL0/Core/Grammar.hpp"
+#include "PL0/Core/Action.hpp"
+#include "PL0/Core/TokenCache.hpp"
+#include "PL0/Utils/SourceBuffer.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace PL0
+{
+namespace
+{
+constexpr std::array<char, 8> MAGIC = {'P', 'L', '0', 'T', 'A', 'B', 'L', 'S'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct Header
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t byteOrder;    // BYTE_ORDER_MARK as written by the machine that stored the file.
+    uint64_t grammarSize;  // The size of the grammar file.
+    uint64_t grammarHash;  // The hash of the grammar file.
+    uint64_t bodyHash;     // The hash of everything after the header, which detects corruption.
+};
+
+/**
+ * @brief Append values to the body of a cache file.
+ */
+class Writer
+{
+public:
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void writeValue(const T& value)
+    {
+        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(std::span<const T> values)
+    {
+        writeValue(uint64_t(values.size()));
+        m_data.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+    }
+
+    void writeString(std::string_view str)
+    {
+        writeValue(uint64_t(str.size()));
+        m_data.append(str);
+    }
+
+    inline const std::string& getData() const
+    {
+        return m_data;
+    }
+
+private:
+    std::string m_data;
+};
+
+/**
+ * @brief Read values from the body of a cache file in the order they are written.
+ * @note Each read returns false instead of reading past the end of the body.
+ */
+class Reader
+{
+public:
+    explicit Reader(std::string_view data) : m_data(data)
+    {
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool readValue(T& value)
+    {
+        if (m_data.size() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_data.data(), sizeof(T));
+        m_data.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values)
+    {
+        uint64_t size;
+        if (!readValue(size) || size > m_data.size() / sizeof(T)) {
+            return false;
+        }
+        values.resize(size);
+        std::memcpy(values.data(), m_data.data(), size * sizeof(T));
+        m_data.remove_prefix(size * sizeof(T));
+        return true;
+    }
+
+    bool readString(std::string& str)
+    {
+        uint64_t size;
+        if (!readValue(size) || size > m_data.size()) {
+            return false;
+        }
+        str.assign(m_data.substr(0, size));
+        m_data.remove_prefix(size);
+        return true;
+    }
+
+    inline bool atEnd() const
+    {
+        return m_data.empty();
+    }
+
+private:
+    std::string_view m_data;
+};
+
+/**
+ * @note An action symbol begins with a digit, e.g. "10".
+ */
+inline bool isActionSymbol(std::string_view sym)
+{
+    return !sym.empty() && isDigit(sym[0]);
+}
+
+/**
+ * @note A non-terminal begins with A-Z, as RuleAnalyzer tells them apart.
+ */
+inline bool isNonTerminalSymbol(std::string_view sym)
+{
+    return !sym.empty() && sym[0] >= 'A' && sym[0] <= 'Z';
+}
+}  // namespace
+
+Grammar Grammar::parse(std::string_view text, std::string_view name)
+{
+    Grammar grammar;
+    size_t lineNumber = 0;
+    auto fail = [&](std::string_view message) {
+        throw std::runtime_error(std::format("{}:{}: {}", name, lineNumber, message));
+    };
+
+    std::map<Symbol, size_t, std::less<>> usedActions;   // <action, the line it is used on>
+    std::map<Symbol, size_t, std::less<>> usedSymbols;   // <non-terminal, the line it is used on>
+    std::map<Symbol, size_t, std::less<>> boundActions;  // <action, the line it is bound on>
+    size_t beginSymLine = 0;
+    Symbol lhs;  // The left-hand side of the last rule.
+
+    /**
+     * @brief Parse a rule of {lhs}, which is the words between "->" or '|' and the next '|'.
+     */
+    auto parseRule = [&](std::span<const std::string_view> words) {
+        if (words.empty()) {
+            fail("A rule has no symbols. Write ε for an empty right-hand side.");
+        }
+        std::vector<Symbol> rhs;
+        int indexOffset = NULL_OFFSET;
+        size_t symbolCount = 0;
+        bool hasEpsilon = false;
+        for (size_t i = 0; i < words.size(); ++i) {
+            std::string_view word = words[i];
+            if (word[0] == '@') {
+                auto [end, error] =
+                    std::from_chars(word.data() + 1, word.data() + word.size(), indexOffset);
+                if (error != std::errc() || end != word.data() + word.size()) {
+                    fail(std::format("Invalid index offset {}.", word));
+                }
+                if (i + 1 != words.size()) {
+                    fail("The index offset must be the last word of a rule.");
+                }
+            } else if (word[0] == '{') {
+                std::string_view action = word.substr(1, word.size() - 2);
+                if (word.size() < 3 || word.back() != '}' || !isActionSymbol(action)) {
+                    fail(std::format("Invalid action {}. An action is a name in braces which "
+                                     "begins with a digit, e.g. {{6}}.",
+                                     word));
+                }
+                rhs.emplace_back(action);
+                usedActions.emplace(action, lineNumber);
+            } else if (word == "ε") {
+                if (hasEpsilon) {
+                    fail("ε must be the only symbol of a rule.");
+                }
+                hasEpsilon = true;
+                rhs.push_back(EPSILON);
+            } else {
+                if (isDigit(word[0]) || word[0] == '%' || word == "->") {
+                    fail(std::format("Invalid symbol {}.", word));
+                }
+                rhs.emplace_back(word);
+                ++symbolCount;
+                if (isNonTerminalSymbol(word)) {
+                    usedSymbols.emplace(word, lineNumber);
+                }
+            }
+        }
+        if (hasEpsilon == (symbolCount > 0)) {
+            fail(hasEpsilon ? "ε must be the only symbol of a rule."
+                            : "A rule has no symbols. Write ε for an empty right-hand side.");
+        }
+
+        /**
+         * @note The offset is relative to the position of the left-hand side in the analysis
+         *      stack, where the right-hand side is pushed in reverse order, and a non-terminal
+         *      takes two elements with its synthesized attribute. It must locate an action.
+         */
+        if (indexOffset != NULL_OFFSET) {
+            std::vector<bool> isAction;
+            for (auto it = rhs.rbegin(); it != rhs.rend(); ++it) {
+                if (isNonTerminalSymbol(*it)) {
+                    isAction.push_back(false);
+                }
+                if (*it != EPSILON) {
+                    isAction.push_back(isActionSymbol(*it));
+                }
+            }
+            if (indexOffset < 0 || size_t(indexOffset) >= isAction.size() ||
+                !isAction[indexOffset]) {
+                fail(std::format("The index offset @{} does not locate an action of the rule.",
+                                 indexOffset));
+            }
+        }
+
+        grammar.rules.push_back({lhs, std::move(rhs)});
+        grammar.indexOffsets.push_back(indexOffset);
+    };
+
+    std::vector<std::string_view> words;
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = std::min(text.find('\n', begin), text.size());
+        std::string_view line = text.substr(begin, end - begin);
+        begin = end + 1;
+        ++lineNumber;
+
+        // Split the line into words, until a comment
+        words.clear();
+        for (size_t pos = line.find_first_not_of(" \t\r"); pos != std::string_view::npos;) {
+            size_t wordEnd = std::min(line.find_first_of(" \t\r", pos), line.size());
+            std::string_view word = line.substr(pos, wordEnd - pos);
+            if (word.starts_with("//")) {
+                break;
+            }
+            words.push_back(word);
+            pos = line.find_first_not_of(" \t\r", wordEnd);
+        }
+        if (words.empty()) {
+            continue;
+        }
+
+        if (words[0] == "%begin") {
+            if (words.size() != 2 || !isNonTerminalSymbol(words[1])) {
+                fail("Expected %begin <non-terminal>.");
+            }
+            if (!grammar.beginSym.empty()) {
+                fail("The begin symbol is set more than once.");
+            }
+            grammar.beginSym = words[1];
+            beginSymLine = lineNumber;
+        } else if (words[0] == "%action") {
+            if (words.size() != 3 || words[1].size() < 3 || words[1].front() != '{' ||
+                words[1].back() != '}') {
+                fail("Expected %action {<action>} <function>.");
+            }
+            std::string_view action = words[1].substr(1, words[1].size() - 2);
+            if (!Action::find(words[2])) {
+                fail(std::format("Unknown action function {}.", words[2]));
+            }
+            if (!boundActions.emplace(action, lineNumber).second) {
+                fail(std::format("Action {{{}}} is bound more than once.", action));
+            }
+            grammar.actions.emplace_back(action, words[2]);
+        } else if (words[0][0] == '%') {
+            fail(std::format("Unknown directive {}.", words[0]));
+        } else {
+            size_t pos;
+            if (words[0] == "|") {
+                if (lhs.empty()) {
+                    fail("'|' must follow a rule.");
+                }
+                pos = 1;
+            } else {
+                if (words.size() < 2 || words[1] != "->" || !isNonTerminalSymbol(words[0])) {
+                    fail("Expected <non-terminal> -> <symbols>.");
+                }
+                lhs = words[0];
+                pos = 2;
+            }
+            for (size_t next; pos <= words.size(); pos = next + 1) {
+                next = pos;
+                while (next < words.size() && words[next] != "|") {
+                    ++next;
+                }
+                parseRule(std::span(words).subspan(pos, next - pos));
+            }
+        }
+    }
+
+    // Check the grammar as a whole. The line of the first use of a symbol is reported.
+    if (grammar.rules.empty()) {
+        throw std::runtime_error(std::format("{}: The grammar has no rules.", name));
+    }
+    if (grammar.beginSym.empty()) {
+        grammar.beginSym = grammar.rules[0].lhs;
+    }
+    usedSymbols.emplace(grammar.beginSym, beginSymLine);
+    std::set<Symbol, std::less<>> lhsSymbols;
+    for (const Rule& rule : grammar.rules) {
+        lhsSymbols.insert(rule.lhs);
+    }
+    for (const auto& [sym, line] : usedSymbols) {
+        if (!lhsSymbols.contains(sym)) {
+            lineNumber = line;
+            fail(std::format("{} has no rules.", sym));
+        }
+    }
+    for (const auto& [action, line] : usedActions) {
+        if (!boundActions.contains(action)) {
+            lineNumber = line;
+            fail(std::format("Action {{{}}} is not bound to a function.", action));
+        }
+    }
+    for (const auto& [action, line] : boundActions) {
+        if (!usedActions.contains(action)) {
+            lineNumber = line;
+            fail(std::format("Action {{{}}} is not used by any rule.", action));
+        }
+    }
+    return grammar;
+}
+
+Grammar Grammar::load(const std::string& path)
+{
+    SourceBuffer file(path);
+    return parse(file.view(), path);
+}
+
+ParseTables ParseTables::build(const Grammar& grammar)
+{
+    // The analyzer takes the rules without actions.
+    RuleAnalyzer analyzer(RuleAnalyzer::Mode::Bitsets);
+    analyzer.setBeginSym(grammar.beginSym);
+    std::vector<std::vector<Symbol>> rhsList;
+    rhsList.reserve(grammar.rules.size());
+    for (const Rule& rule : grammar.rules) {
+        std::vector<Symbol> rhsWithoutActions;
+        for (const Symbol& sym : rule.rhs) {
+            if (!isActionSymbol(sym)) {
+                rhsWithoutActions.push_back(sym);
+            }
+        }
+        analyzer.addRule(rule.lhs, rhsWithoutActions);
+        rhsList.push_back(rule.rhs);
+    }
+    analyzer.calcSelectSets();
+
+    // A table cell can only hold one rule.
+    std::map<std::pair<Symbol, Symbol>, size_t> predictions;
+    for (size_t i = 0; i < grammar.rules.size(); ++i) {
+        for (const Symbol& sym : analyzer.getSelectSet(i)) {
+            auto [it, inserted] = predictions.emplace(std::pair{grammar.rules[i].lhs, sym}, i);
+            if (!inserted) {
+                throw std::runtime_error(std::format(
+                    "The grammar is not LL(1): rules {} and {} of {} are both selected by {}.",
+                    it->second + 1, i + 1, grammar.rules[i].lhs, sym));
+            }
+        }
+    }
+
+    return {PredictionTable(analyzer, rhsList), grammar.indexOffsets, grammar.actions};
+}
+
+ParseTables ParseTables::load(const std::string& grammarPath,
+                              const std::filesystem::path& cachePath)
+{
+    std::filesystem::path path =
+        cachePath.empty() ? std::filesystem::path(grammarPath + ".tables") : cachePath;
+    SourceBuffer grammarFile(grammarPath);
+    if (std::optional<ParseTables> tables = loadCache(path, grammarFile.view())) {
+        return std::move(*tables);
+    }
+
+    ParseTables tables = build(Grammar::parse(grammarFile.view(), grammarPath));
+    tables.storeCache(path, grammarFile.view());
+    return tables;
+}
+
+std::optional<ParseTables> ParseTables::loadCache(const std::filesystem::path& path,
+                                                  std::string_view grammarText)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return std::nullopt;
+    }
+
+    std::unique_ptr<SourceBuffer> file;
+    try {
+        file = std::make_unique<SourceBuffer>(path.string());
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+
+    // Check the header
+    Header header;
+    if (file->size() < sizeof(Header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, file->data(), sizeof(Header));
+    std::string_view body = file->view().substr(sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || header.grammarSize != grammarText.size() ||
+        header.grammarHash != TokenCache::hash(grammarText) ||
+        header.bodyHash != TokenCache::hash(body)) {
+        return std::nullopt;
+    }
+
+    // Read the body in the order storeCache() writes it
+    Reader reader(body);
+    uint64_t symbolCount;
+    if (!reader.readValue(symbolCount) || symbolCount > body.size()) {
+        return std::nullopt;
+    }
+    std::vector<Symbol> names(symbolCount);
+    for (Symbol& name : names) {
+        if (!reader.readString(name)) {
+            return std::nullopt;
+        }
+    }
+    uint32_t terminalCount, nonTerminalCount;
+    SymbolId beginSym;
+    std::vector<uint32_t> cells, rhsOffsets;
+    std::vector<SymbolId> rhsPool;
+    ParseTables tables;
+    uint64_t actionCount;
+    if (!reader.readValue(terminalCount) || !reader.readValue(nonTerminalCount) ||
+        !reader.readValue(beginSym) || !reader.readArray(cells) || !reader.readArray(rhsOffsets) ||
+        !reader.readArray(rhsPool) || !reader.readArray(tables.indexOffsets) ||
+        !reader.readValue(actionCount) || actionCount > body.size()) {
+        return std::nullopt;
+    }
+    tables.actions.resize(actionCount);
+    for (auto& [action, function] : tables.actions) {
+        if (!reader.readString(action) || !reader.readString(function)) {
+            return std::nullopt;
+        }
+    }
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+
+    try {
+        tables.predictionTable =
+            PredictionTable(std::move(names), terminalCount, nonTerminalCount, beginSym,
+                            std::move(cells), std::move(rhsOffsets), std::move(rhsPool));
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    if (tables.indexOffsets.size() != tables.predictionTable.getRuleCount()) {
+        return std::nullopt;
+    }
+    return tables;
+}
+
+void ParseTables::storeCache(const std::filesystem::path& path,
+                             std::string_view grammarText) const
+{
+    const PredictionTable& table = predictionTable;
+    Writer writer;
+    writer.writeValue(uint64_t(table.getSymbolCount()));
+    for (std::string_view name : table.getNames()) {
+        writer.writeString(name);
+    }
+    writer.writeValue(uint32_t(table.getTerminalCount()));
+    writer.writeValue(uint32_t(table.getNonTerminalCount()));
+    writer.writeValue(table.getBeginSym());
+    writer.writeArray(table.getCells());
+    writer.writeArray(table.getRhsOffsets());
+    writer.writeArray(table.getRhsPool());
+    writer.writeArray(std::span<const int>(indexOffsets));
+    writer.writeValue(uint64_t(actions.size()));
+    for (const auto& [action, function] : actions) {
+        writer.writeString(action);
+        writer.writeString(function);
+    }
+    const std::string& body = writer.getData();
+
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.grammarSize = grammarText.size();
+    header.grammarHash = TokenCache::hash(grammarText);
+    header.bodyHash = TokenCache::hash(body);
+
+    std::error_code error;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+    std::filesystem::path temporary = path;
+    temporary += std::format(".{:08x}.tmp", std::random_device()());
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+}  // namespace PL0
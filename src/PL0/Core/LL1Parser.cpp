@@ -1,88 +1,135 @@
 #include "PL0/Core/LL1Parser.hpp"
+#include "PL0/Core/StaticTable.hpp"
 #include "PL0/Utils/Error.hpp"
 #include "PL0/Utils/Reporter.hpp"
 #include <format>
 #include <stack>
+#include <stdexcept>
 
 namespace PL0
 {
-LL1Parser::LL1Parser()
+namespace
 {
-    initSyntax();
+/**
+ * @note The syntax of arithmetic expressions:
+ *  S -> E
+ *  E -> + T E'
+ *  E -> - T E'
+ *  E -> T E'
+ *  E' -> + T E'
+ *  E' -> - T E'
+ *  E' -> ε
+ *  T -> F T'
+ *  T' -> * F T'
+ *  T' -> / F T'
+ *  T' -> ε
+ *  F -> ( E )
+ *  F -> id
+ *  F -> num
+ */
+constexpr StaticRule EXPRESSION_RULES[] = {
+    {"S", "E"},
+    {"E", "+ E'"},
+    {"E", "- E'"},
+    {"E", "E'"},
+    {"E'", "T E''"},
+    {"E''", "+ T E''"},
+    {"E''", "- T E''"},
+    {"E''", "ε"},
+    {"T", "F T'"},
+    {"T'", "* F T'"},
+    {"T'", "/ F T'"},
+    {"T'", "ε"},
+    {"F", "( E )"},
+    {"F", "id"},
+    {"F", "num"},
+};
+
+/**
+ * @note The tables are generated at compile time, so the parser costs nothing to build.
+ */
+using ExpressionTable = StaticTable<EXPRESSION_RULES>;
+
+constexpr std::array<SymbolId, TOKEN_KIND_COUNT> EXPRESSION_KIND_SYMBOLS =
+    ExpressionTable::findSymbols(TOKEN_KIND_SYMBOLS);
+}  // namespace
+
+LL1Parser::LL1Parser(ExpressionEngine engine)
+    : m_predictionTable(ExpressionTable::getPredictionTable()),
+      m_kindSymbols(EXPRESSION_KIND_SYMBOLS)
+{
+    if (engine == ExpressionEngine::Pratt) {
+        m_pratt.emplace(PrattParser::Mode::Syntax);
+    }
 }
 
-void LL1Parser::initSyntax()
+LL1Parser::LL1Parser(const ParseTables& tables) : m_predictionTable(tables.predictionTable)
 {
-    /**
-     * @note The syntax of arithmetic expressions:
-     *  S -> E
-     *  E -> + T E'
-     *  E -> - T E'
-     *  E -> T E'
-     *  E' -> + T E'
-     *  E' -> - T E'
-     *  E' -> ε
-     *  T -> F T'
-     *  T' -> * F T'
-     *  T' -> / F T'
-     *  T' -> ε
-     *  F -> ( E )
-     *  F -> id
-     *  F -> num
-     */
+    if (m_predictionTable.getSymbolCount() !=
+        m_predictionTable.getTerminalCount() + m_predictionTable.getNonTerminalCount()) {
+        throw std::runtime_error("The grammar of LL1Parser must not have actions.");
+    }
+    initKindSymbols();
+}
+
+void LL1Parser::initKindSymbols()
+{
+    for (size_t kind = 0; kind < TOKEN_KIND_COUNT; ++kind) {
+        m_kindSymbols[kind] = m_predictionTable.findSymbol(TOKEN_KIND_SYMBOLS[kind]);
+    }
+}
 
-    m_analyzer.setBeginSym("S");
-
-    m_analyzer.addRule("S", {"E"});
-    m_analyzer.addRule("E", {"+", "E'"});
-    m_analyzer.addRule("E", {"-", "E'"});
-    m_analyzer.addRule("E", {"E'"});
-    m_analyzer.addRule("E'", {"T", "E''"});
-    m_analyzer.addRule("E''", {"+", "T", "E''"});
-    m_analyzer.addRule("E''", {"-", "T", "E''"});
-    m_analyzer.addRule("E''", {EPSILON});
-    m_analyzer.addRule("T", {"F", "T'"});
-    m_analyzer.addRule("T'", {"*", "F", "T'"});
-    m_analyzer.addRule("T'", {"/", "F", "T'"});
-    m_analyzer.addRule("T'", {EPSILON});
-    m_analyzer.addRule("F", {"(", "E", ")"});
-    m_analyzer.addRule("F", {"id"});
-    m_analyzer.addRule("F", {"num"});
-
-    m_analyzer.calcSelectSets();
-    generatePredictionTable();
+void LL1Parser::parse(TokenSource& tokens) const
+{
+    if (m_pratt) {
+        m_pratt->parse(tokens);
+        return;
+    }
+    analyze(tokens, nullptr);
 }
 
-void LL1Parser::generatePredictionTable()
+void LL1Parser::parse(TokenSource& tokens, CompilationUnit& unit) const
 {
-    const auto& rules = m_analyzer.getRules();
-    for (size_t i = 0; i < rules.size(); ++i) {
-        const auto& rule = rules[i];
-        const Symbol& lhs = rule.lhs;
-        const std::set<Symbol>& selectSet = m_analyzer.getSelectSet(i);
-
-        for (const Symbol& sym : selectSet) {
-            m_predictionTable[lhs][sym] = rule.rhs;
-        }
+    if (m_pratt) {
+        m_pratt->parse(tokens, unit);
+        return;
+    }
+    unit.reset(tokens.getSource());
+    ExpressionBuilder builder(unit);
+    if (analyze(tokens, &builder)) {
+        unit.setRoot(builder.finish());
+    } else {
+        unit.reset(tokens.getSource());
     }
 }
 
-void LL1Parser::parse(const std::vector<Token>& tokens)
+bool LL1Parser::analyze(TokenSource& tokens, ExpressionBuilder* builder) const
 {
     /**
-     * @note Input stack (The bottom is at index 0):
-     *   a + 5 * b  =>
-     *   ----------------------------
-     *   | ENDSYM  id  *  num  +  id   <---
-     *   ----------------------------
+     * @note Instead of an input stack, only the lookahead symbol is kept.
+     *      The tokens are pulled from the source and translated one by one, and ENDSYM is used
+     *      as the lookahead once the source is exhausted:
+     *   a + 5 * b  =>  id  +  num  *  id  ENDSYM
+     *                  ^ lookahead
+     * @note The symbols are IDs in the prediction table, so the loop compares and indexes
+     *      integers only. The names are looked up for diagnostics.
      */
-    std::vector<Symbol> inputStack{ENDSYM};
-
-    // Tranlate all tokens to symbols and push them in reverse order.
-    for (auto it = tokens.rbegin(); it != tokens.rend(); ++it) {
-        Symbol symbol = translate2Symbol(*it);
-        inputStack.push_back(symbol);
-    }
+    const PredictionTable& table = m_predictionTable;
+    Token token;
+    uint32_t itopOffset = NO_OFFSET;  // The offset of the lookahead token, if it exists.
+    auto nextSymbol = [&]() -> SymbolId {
+        if (!tokens.next(token)) {
+            itopOffset = NO_OFFSET;
+            return table.getEndSym();
+        }
+        itopOffset = token.offset;
+        return m_kindSymbols[static_cast<size_t>(token.kind)];
+    };
+    auto itopName = [&]() -> std::string_view {
+        return itopOffset != NO_OFFSET ? translate2Symbol(token) : std::string_view(ENDSYM);
+    };
+    SymbolId itop = nextSymbol();
+    bool inputConsumed = false;  // Whether ENDSYM has been matched.
 
     /**
      * @note Analysis stack (The bottom is at index 0):
@@ -91,95 +138,86 @@ void LL1Parser::parse(const std::vector<Token>& tokens)
      *    |  ENDSYM  BEGINSYM      <---
      *    --------------------
      */
-    std::vector<Symbol> analysisStack{ENDSYM, m_analyzer.getBeginSym()};
+    std::vector<SymbolId> analysisStack{table.getEndSym(), table.getBeginSym()};
 
     try {
-        while (!analysisStack.empty() && !inputStack.empty()) {
-            Symbol atop = analysisStack.back();
-            Symbol itop = inputStack.back();
+        while (!analysisStack.empty() && !inputConsumed) {
+            SymbolId atop = analysisStack.back();
 
             /**
              * @note If the top of the analysis stack is a terminal symbol or the end symbol,
              *      then it should match the top of the input stack.
              */
-            if (m_analyzer.isTerminal(atop) || atop == ENDSYM) {
+            if (table.isTerminal(atop)) {
                 if (atop != itop) {  // Mismatch
                     throw SyntaxError(std::format(
-                        "The terminal symbol {} does not match the top of the input stack {}.",
-                        atop, itop));
+                        "{}The terminal symbol {} does not match the top of the input stack {}.",
+                        locate(tokens, itopOffset), table.getName(atop), itopName()));
                 }
 
-                // Pop analysis stack and input stack.
+                // Pop analysis stack and move to the next input symbol.
                 analysisStack.pop_back();
-                inputStack.pop_back();
+                if (itop == table.getEndSym()) {
+                    inputConsumed = true;
+                } else {
+                    if (builder) {
+                        builder->push(token);
+                    }
+                    itop = nextSymbol();
+                }
             } else {
                 /**
                  * @note If the top of the analysis stack is a non-terminal symbol X,
                  *     find the production rule X -> Y1Y2...Yn in the prediction table,
-                 *     and replace X with Y1Y2...Yn (in reverse order) in the analysis stack (except ε).
+                 *     and replace X with Y1Y2...Yn (in reverse order) in the analysis stack.
+                 *     ε is not stored in the table.
                  */
 
-                const auto& items = m_predictionTable[atop];
-                if (items.find(itop) == items.end()) {  // No such production rule
-                    throw SyntaxError(std::format("{} is not allowed.", itop));
+                uint32_t rule = itop != PredictionTable::NO_SYMBOL ? table.predict(atop, itop)
+                                                                    : PredictionTable::NO_RULE;
+                if (rule == PredictionTable::NO_RULE) {  // No such production rule
+                    throw SyntaxError(std::format("{}{} is not allowed.",
+                                                  locate(tokens, itopOffset), itopName()));
                 }
-                const auto& rhs = m_predictionTable[atop][itop];
+                std::span<const SymbolId> rhs = table.getRhs(rule);
 
                 // 1) Pop X
                 analysisStack.pop_back();
 
                 // 2) Push Yn, Yn-1, ..., Y1
-                for (auto it = rhs.rbegin(); it != rhs.rend(); ++it) {
-                    if (*it != EPSILON) {  // Skip ε
-                        analysisStack.push_back(*it);
-                    }
-                }
+                analysisStack.insert(analysisStack.end(), rhs.rbegin(), rhs.rend());
             }
         }
     } catch (const SyntaxError& e) {
         Reporter::error(e.what());
-        return;
+        return false;
     }
 
     /**
-     * @note It is impossible that one of the stacks is empty while the other is not.
+     * @note It is impossible that the analysis stack is empty while the input is not consumed,
+     *      or the other way around.
      */
     Reporter::success("Syntax correct.");
+    return true;
 }
 
-void LL1Parser::printPredictionTable()
+void LL1Parser::printPredictionTable() const
 {
-    for (const auto& [lhs, item] : m_predictionTable) {
-        std::cout << lhs << " -- ";
-        for (const auto& [sym, rule] : item) {
-            std::cout << sym << " -> ";
-            for (const auto& s : rule) {
-                if (s == EPSILON) {
-                    std::cout << "ε";
-                } else {
-                    std::cout << s;
-                }
-            }
-            std::cout << ", ";
-        }
-        std::cout << "\n";
-    }
+    m_predictionTable.print();
 }
 
-void LL1Parser::printState(const std::vector<Symbol>& analysisStack,
-                           const std::vector<Symbol>& inputStack)
+void LL1Parser::printState(const std::vector<SymbolId>& analysisStack, SymbolId lookahead) const
 {
     std::cout << "Analysis stack: ";
-    for (const auto& sym : analysisStack) {
-        std::cout << sym << " ";
+    for (SymbolId sym : analysisStack) {
+        std::cout << m_predictionTable.getName(sym) << " ";
     }
     std::cout << "\n";
 
-    std::cout << "Input stack: ";
-    for (auto it = inputStack.rbegin(); it != inputStack.rend(); ++it) {
-        std::cout << *it << " ";
-    }
-    std::cout << "\n";
+    std::cout << "Lookahead: "
+              << (lookahead != PredictionTable::NO_SYMBOL ? m_predictionTable.getName(lookahead)
+                                                          : "nul")
+              << "\n";
     std::cout << "--------------------------------------------------------------------------\n";
 }
 }  // namespace PL0
\ No newline at end of file
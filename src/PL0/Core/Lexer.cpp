@@ -1,99 +1,781 @@
 #include "PL0/Core/Lexer.hpp"
+#include "PL0/Core/TokenCache.hpp"
 #include "PL0/Utils/Reporter.hpp"
+#include "PL0/Utils/SimdScan.hpp"
 
 #include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace PL0
 {
-std::vector<Token> Lexer::tokenize(const std::string& srcFile)
+namespace
 {
-    // Initialize the scanner
-    m_scanner = std::make_unique<Scanner>(srcFile);
+/**
+ * @brief The states of the DFA for the table-driven mode.
+ * @note The states before AcceptWord consume the current character.
+ *      The accepting states do not: the token is [token begin, current character).
+ *      So every token is recognized by looking one character ahead, and single-character tokens
+ *      pass through an After* state first.
+ */
+enum class LexState : uint8_t
+{
+    Start = 0,
+    InWord,           // Keyword or identifier
+    InNumber,         // Number
+    InBadNumber,      // Number followed by alphabets, e.g. 12ab
+    AfterRelational,  // < or >, which may be followed by =
+    AfterColon,       // :, which must be followed by =
+    AfterOperator,    // A complete operator
+    AfterDelimiter,   // A complete delimiter
+    AfterUnknown,     // A character that cannot begin any token
+    InComment,        // Between { and }
+
+    // Accepting states
+    AcceptWord,
+    AcceptNumber,
+    AcceptBadNumber,
+    AcceptOperator,
+    AcceptBadColon,
+    AcceptDelimiter,
+    AcceptUnknown,
+    AcceptEnd,
+    Count
+};
+
+constexpr size_t STATE_COUNT = static_cast<size_t>(LexState::Count);
+constexpr size_t CHAR_CLASS_COUNT = static_cast<size_t>(CharClass::Count);
+
+using TransitionTable = std::array<std::array<LexState, CHAR_CLASS_COUNT>, STATE_COUNT>;
+
+/**
+ * @brief The state-transition table: < current state, <class of current character, next state> >
+ */
+constexpr TransitionTable TRANSITIONS = [] {
+    TransitionTable table{};
+    auto set = [&table](LexState from, CharClass cls, LexState to) {
+        table[static_cast<size_t>(from)][static_cast<size_t>(cls)] = to;
+    };
+    auto setAll = [&table](LexState from, LexState to) {
+        table[static_cast<size_t>(from)].fill(to);
+    };
+
+    setAll(LexState::Start, LexState::AfterUnknown);
+    set(LexState::Start, CharClass::Space, LexState::Start);
+    set(LexState::Start, CharClass::Alpha, LexState::InWord);
+    set(LexState::Start, CharClass::Digit, LexState::InNumber);
+    set(LexState::Start, CharClass::Delimiter, LexState::AfterDelimiter);
+    set(LexState::Start, CharClass::Operator, LexState::AfterOperator);
+    set(LexState::Start, CharClass::Equal, LexState::AfterOperator);
+    set(LexState::Start, CharClass::Relational, LexState::AfterRelational);
+    set(LexState::Start, CharClass::Colon, LexState::AfterColon);
+    set(LexState::Start, CharClass::LBrace, LexState::InComment);
+    set(LexState::Start, CharClass::End, LexState::AcceptEnd);
+
+    setAll(LexState::InWord, LexState::AcceptWord);
+    set(LexState::InWord, CharClass::Alpha, LexState::InWord);
+    set(LexState::InWord, CharClass::Digit, LexState::InWord);
+
+    setAll(LexState::InNumber, LexState::AcceptNumber);
+    set(LexState::InNumber, CharClass::Digit, LexState::InNumber);
+    set(LexState::InNumber, CharClass::Alpha, LexState::InBadNumber);
+
+    setAll(LexState::InBadNumber, LexState::AcceptBadNumber);
+    set(LexState::InBadNumber, CharClass::Alpha, LexState::InBadNumber);
+    set(LexState::InBadNumber, CharClass::Digit, LexState::InBadNumber);
+
+    setAll(LexState::AfterRelational, LexState::AcceptOperator);
+    set(LexState::AfterRelational, CharClass::Equal, LexState::AfterOperator);
+
+    setAll(LexState::AfterColon, LexState::AcceptBadColon);
+    set(LexState::AfterColon, CharClass::Equal, LexState::AfterOperator);
+
+    setAll(LexState::AfterOperator, LexState::AcceptOperator);
+    setAll(LexState::AfterDelimiter, LexState::AcceptDelimiter);
+    setAll(LexState::AfterUnknown, LexState::AcceptUnknown);
+
+    setAll(LexState::InComment, LexState::InComment);
+    set(LexState::InComment, CharClass::RBrace, LexState::Start);
+    set(LexState::InComment, CharClass::End, LexState::AcceptEnd);
+
+    return table;
+}();
+
+/**
+ * @note EOF must always lead to an accepting state, otherwise the DFA would read past the end.
+ */
+static_assert([] {
+    for (size_t state = 0; state < static_cast<size_t>(LexState::AcceptWord); ++state) {
+        if (TRANSITIONS[state][static_cast<size_t>(CharClass::End)] < LexState::AcceptWord) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+/**
+ * @brief Make a keyword or identifier token from a word.
+ * @param source The source buffer which the word points into.
+ * @param interner The table to intern the identifier in.
+ * @param word An alphabet followed by alphabets and digits.
+ */
+Token makeWordToken(SourceBuffer& source, Interner& interner, std::string_view word)
+{
+    /**
+     * @note The keyword is recognized from the raw characters, ignoring case.
+     *      A keyword takes its lowercase spelling from KEYWORDS, so only identifiers need to be
+     *      converted to lowercase in the source buffer.
+     */
+    Keyword keyword = findKeyword(word);
+    if (keyword != Keyword::None) {
+        return {.type = TokenType::Keyword,
+                .keyword = keyword,
+                .kind = toKind(keyword),
+                .value = toString(keyword)};
+    }
+
+    source.toLower(word);  // Convert to lowercase
+    return {.type = TokenType::Identifier,
+            .kind = TokenKind::Ident,
+            .id = interner.intern(word),
+            .value = word};
+}
+
+/**
+ * @return Whether the token has a lexical error: it is invalid, or a number out of range.
+ */
+inline bool hasError(const Token& token)
+{
+    return token.type == TokenType::Invalid || token.outOfRange;
+}
+
+/**
+ * @brief Report the lexical error of a token at a location.
+ * @note The kind of error is told by the first character of the token.
+ */
+void reportTokenError(SourceLocation where, const Token& token)
+{
+    std::string location = where.toString();
+    if (token.outOfRange) {
+        Reporter::error(std::format("{}: Number out of range: {}", location, token.value));
+    } else if (isDigit(token.value[0])) {
+        Reporter::error(std::format("{}: Invalid identifier: {}", location, token.value));
+    } else if (token.value[0] == ':') {
+        Reporter::error(std::format("{}: Invalid operator: {}", location, token.value));
+    } else {
+        Reporter::error(std::format("{}: Unknown symbol: {}", location, token.value));
+    }
+}
 
+/**
+ * @brief Report the lexical error of a token, with its line and column.
+ */
+void reportTokenError(const SourceBuffer& source, const Token& token)
+{
+    reportTokenError(source.getLocation(token.offset), token);
+}
+
+/**
+ * @brief Scan the next token with the DFA.
+ * @param source The source buffer.
+ * @param interner The table to intern the identifiers in.
+ * @param cur The cursor. It will be moved to the next character after the token.
+ * @param end The end of the characters to scan. It must not be in the middle of a token.
+ * @param token The token scanned.
+ * @return false if all tokens have been scanned.
+ * @note Lexical errors are not reported here (see reportTokenError).
+ */
+bool scanToken(SourceBuffer& source, Interner& interner, const char*& cur, const char* end,
+               Token& token)
+{
+    const char* tokenBegin = cur;
+
+    /**
+     * @note Runs of spaces and the bodies of comments are skipped in bulk (with SIMD instructions
+     *      if possible) instead of one transition per character. The DFA then continues from the
+     *      first non-space character, or from the closing '}' (or EOF) of the comment.
+     */
+    LexState state = LexState::Start;
+    while (true) {
+        if (state == LexState::Start) {
+            cur = skipSpaces(cur, end);
+            tokenBegin = cur;
+        }
+
+        CharClass cls = cur != end ? classify(*cur) : CharClass::End;
+        state = TRANSITIONS[static_cast<size_t>(state)][static_cast<size_t>(cls)];
+        if (state < LexState::AcceptWord) {
+            ++cur;
+            if (state == LexState::InComment) {
+                cur = findCommentEnd(cur, end);
+            }
+            continue;
+        }
+
+        std::string_view value(tokenBegin, cur - tokenBegin);
+        switch (state) {
+        case LexState::AcceptWord: {
+            token = makeWordToken(source, interner, value);
+            break;
+        }
+        case LexState::AcceptNumber: {
+            token = makeNumberToken(value);
+            break;
+        }
+        case LexState::AcceptBadNumber: {
+            token = {.type = TokenType::Invalid, .value = value};
+            break;
+        }
+        case LexState::AcceptOperator: {
+            token = {.type = TokenType::Operator,
+                     .kind = findPunctuationKind(value),
+                     .value = value};
+            break;
+        }
+        case LexState::AcceptBadColon: {
+            token = {.type = TokenType::Invalid, .value = value};
+            break;
+        }
+        case LexState::AcceptDelimiter: {
+            token = {.type = TokenType::Delimiter,
+                     .kind = SINGLE_CHAR_KINDS[static_cast<unsigned char>(value[0])],
+                     .value = value};
+            break;
+        }
+        case LexState::AcceptUnknown: {
+            token = {.type = TokenType::Invalid, .value = value};
+            break;
+        }
+        default: {  // AcceptEnd: All tokens have been scanned.
+            return false;
+        }
+        }
+        token.offset = static_cast<uint32_t>(tokenBegin - source.data());
+        return true;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel lexing
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Files smaller than this are not worth splitting into chunks.
+ */
+constexpr size_t MIN_CHUNK_SIZE = size_t(1) << 20;
+
+/**
+ * @brief A part of the source that is lexed by one thread.
+ * @note Chunks are split right after a space, so no token crosses the boundary except comments.
+ *      Whether a chunk begins inside a comment depends on all the chunks before it, so both
+ *      cases are computed speculatively first and resolved when the chunks are merged.
+ */
+struct Chunk
+{
+    const char* begin;
+    const char* end;
+    bool endsInComment[2];  // Whether the chunk ends inside a comment, if it begins outside (0)
+                            // or inside (1) a comment.
+    bool hasEof[2];         // Whether the chunk contains EOF (the byte 0xFF) outside a comment
+                            // or at the end of one, in the same two cases.
+    bool beginsInComment = false;
     std::vector<Token> tokens;
+    std::vector<size_t> errors;   // The indices of the tokens with lexical errors.
+    Interner names;               // The identifiers of the chunk, merged into the lexer's table.
+};
+
+/**
+ * @brief Follow the comments through [cur, end) without lexing the tokens.
+ * @param inComment Whether cur is inside a comment.
+ * @param hasEof Set to whether EOF is found, at which the scan stops.
+ * @return Whether the scan ends inside a comment.
+ * @note '{' and '}' can only appear as single-character tokens or in comments, so the braces
+ *      alone decide where the comments are.
+ */
+bool followComments(const char* cur, const char* end, bool inComment, bool& hasEof)
+{
+    hasEof = false;
+    for (; cur != end; ++cur) {
+        char c = *cur;
+        if (c == static_cast<char>(EOF)) {
+            hasEof = true;
+            break;
+        }
+        if (inComment) {
+            inComment = c != '}';
+        } else {
+            inComment = c == '{';
+        }
+    }
+    return inComment;
+}
+
+/**
+ * @brief Lex a chunk whose beginning state has been resolved.
+ */
+void lexChunk(SourceBuffer& source, Chunk& chunk)
+{
+    const char* cur = chunk.begin;
+    if (chunk.beginsInComment) {
+        cur = findCommentEnd(cur, chunk.end);
+        if (cur == chunk.end || *cur != '}') {  // The whole chunk is comment, or EOF is reached.
+            return;
+        }
+        ++cur;
+    }
+
+    chunk.tokens.reserve((chunk.end - cur) / 4);
+    Token token;
+    while (scanToken(source, chunk.names, cur, chunk.end, token)) {
+        if (hasError(token)) {
+            chunk.errors.push_back(chunk.tokens.size());
+        }
+        chunk.tokens.push_back(token);
+    }
+}
+
+/**
+ * @brief Run {fn}(i) for i in [0, count) on separate threads.
+ */
+template <typename Fn>
+void runInParallel(size_t count, Fn fn)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(fn, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Re-lexing
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @return Whether a token that ends with {last} goes on with {next}, e.g. "<" and "=", or two
+ *      alphabets of an identifier.
+ */
+bool joins(char last, char next)
+{
+    auto isWord = [](CharClass cls) { return cls == CharClass::Alpha || cls == CharClass::Digit; };
+    CharClass before = classify(last);
+    CharClass after = classify(next);
+    return (isWord(before) && isWord(after)) ||
+           ((before == CharClass::Relational || before == CharClass::Colon) &&
+            after == CharClass::Equal);
+}
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// TokenStream
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+TokenStream::TokenStream(const std::string& srcFile, std::shared_ptr<Interner> interner)
+    : TokenStream(std::make_shared<SourceBuffer>(srcFile), std::move(interner))
+{
+}
+
+TokenStream::TokenStream(std::shared_ptr<SourceBuffer> buffer, std::shared_ptr<Interner> interner)
+    : TokenSource(buffer), m_buffer(std::move(buffer)), m_cur(m_buffer->data()),
+      m_interner(interner ? std::move(interner) : std::make_shared<Interner>())
+{
+}
+
+bool TokenStream::next(Token& token)
+{
+    if (!scanToken(*m_buffer, *m_interner, m_cur, m_buffer->data() + m_buffer->size(), token)) {
+        return false;
+    }
+    if (hasError(token)) {
+        reportTokenError(*m_buffer, token);
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Lexer
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+TokenList Lexer::tokenize(const std::string& srcFile, std::shared_ptr<Interner> interner) const
+{
+    return tokenize(std::make_shared<SourceBuffer>(srcFile), std::move(interner));
+}
+
+TokenList Lexer::tokenize(std::shared_ptr<SourceBuffer> source,
+                          std::shared_ptr<Interner> interner) const
+{
+    if (!interner) {
+        interner = std::make_shared<Interner>();
+    }
+    if (m_cacheDirectory.empty()) {
+        TokenList tokens(source, interner);
+        lex(source, *interner, tokens);
+        return tokens;
+    }
+
+    // The key must be taken before lexing, which converts the identifiers to lowercase.
+    TokenCache cache(m_cacheDirectory);
+    uint64_t key = TokenCache::hash(source->view());
+    if (std::optional<TokenList> cached = cache.load(key, source, interner)) {
+        for (const Token& token : *cached) {
+            if (hasError(token)) {
+                reportTokenError(*source, token);
+            }
+        }
+        return std::move(*cached);
+    }
+
+    TokenList tokens(source, interner);
+    lex(source, *interner, tokens);
+    cache.store(key, tokens);
+    return tokens;
+}
+
+void Lexer::lex(const std::shared_ptr<SourceBuffer>& buffer, Interner& interner,
+                TokenList& tokens) const
+{
+    SourceBuffer& source = *buffer;
+
+    /**
+     * @note A token and the space around it take about 4~5 bytes on average.
+     *      Reserving the memory up front avoids copying the tokens again and again while the
+     *      list grows. The untouched part of the reservation costs no physical memory.
+     */
+    tokens.reserve(source.size() / 4);
+
+    if (m_mode == Mode::TableDriven) {
+        size_t threadCount = getThreadCount();
+        if (threadCount > 1 && source.size() >= threadCount * MIN_CHUNK_SIZE) {
+            tokenizeInParallel(source, interner, tokens, threadCount);
+        } else {
+            const char* cur = source.data();
+            Token token;
+            while (scanToken(source, interner, cur, source.data() + source.size(), token)) {
+                if (hasError(token)) {
+                    reportTokenError(source, token);
+                }
+                tokens.push_back(token);
+            }
+        }
+        return;
+    }
+
+    Scanner scanner(buffer);  // Local to this call, so the lexer stays re-entrant.
     while (true) {
-        m_scanner->skipSpaceAndComments();
-        char c = m_scanner->get();  // First available character of a token
+        scanner.skipSpaceAndComments();
+        char c = scanner.get();  // First available character of a token
 
         if (c == EOF) {  // All tokens have been scanned.
             break;
         }
 
+        uint32_t offset = static_cast<uint32_t>(scanner.getOffset());
         Token token;
         if (isAlpha(c)) {
-            token = getKeywordOrIdentifier();
+            token = getKeywordOrIdentifier(scanner, interner);
         } else if (isDigit(c)) {
-            token = getNumber();
+            token = getNumber(scanner);
         } else if (isDelimiter(c)) {
-            token = getDelimiter();
+            token = getDelimiter(scanner);
         } else if (isOperatorChar(c)) {
-            token = getOperator();
+            token = getOperator(scanner);
         } else {
-            token = getUnknownSymbol();
+            token = getUnknownSymbol(scanner);
+        }
+        token.offset = offset;
+        if (hasError(token)) {
+            reportTokenError(source, token);
         }
         tokens.push_back(token);
     }
+}
 
-    m_scanner.reset();
-    return tokens;
+TokenStream Lexer::stream(const std::string& srcFile, std::shared_ptr<Interner> interner) const
+{
+    return TokenStream(srcFile, std::move(interner));
+}
+
+TokenStream Lexer::stream(std::shared_ptr<SourceBuffer> source,
+                          std::shared_ptr<Interner> interner) const
+{
+    return TokenStream(std::move(source), std::move(interner));
 }
 
-Token Lexer::getKeywordOrIdentifier()
+void Lexer::relex(TokenDocument& document, const SourceEdit& edit) const
 {
+    if (edit.offset > document.size() || edit.removed > document.size() - edit.offset) {
+        throw std::out_of_range("The edit is out of the source.");
+    }
+    std::vector<TokenDocument::Segment>& segments = document.m_segments;
+
     /**
-     * @note The first character of a keyword or an identifier must be an alphabet.
-     *      For keywords, the following characters are all alphabets.
-     *      For identifiers, the following characters can be either alphabets or digits.
+     * @note The damaged segments are merged into one text, from the segment of the byte before
+     *      the edit (a token that ends right at the edit is damaged as well, since the edit may
+     *      extend it, e.g. "<" followed by an inserted "="), to the segment of the last removed
+     *      byte. Offsets in the text are relative to its first segment.
      */
-    Token token;
-    token.value = m_scanner->getUntil(isAlphaOrDigit);
-    std::ranges::transform(token.value, token.value.begin(), ::tolower);  // Convert to lowercase
+    size_t first = document.findSegment(std::max<size_t>(edit.offset, 1) - 1);
+    size_t next = first;  // The first segment after the merged ones.
+    size_t start = segments[first].start;
+    std::vector<Token> oldTokens;  // The tokens of the merged segments, before the edit.
 
     /**
-     * @note If the token is found in the KEYWORDS array, it is a keyword.
-     *      Otherwise, we treat it as an identifier (in the lexical phase).
+     * @brief Merge the following segments into {text}, until at least {bytes} bytes are merged.
+     * @note The next segment is merged as well if the text is too short to be a segment, or if a
+     *      token at the end of the text may go on in it. Then the DFA is in the start state at
+     *      the end of the text, unless it is in a comment.
      */
-    if (std::ranges::find(KEYWORDS, token.value) != KEYWORDS.end()) {
-        token.type = TokenType::Keyword;
-    } else {
-        token.type = TokenType::Identifier;
+    auto absorb = [&](std::string& text, size_t bytes) {
+        size_t absorbed = 0;
+        while (next != segments.size() &&
+               (absorbed < bytes || text.size() < TokenDocument::SEGMENT_SIZE / 2 ||
+                joins(text.back(), segments[next].text->view().front()))) {
+            const TokenDocument::Segment& segment = segments[next++];
+            for (Token token : segment.tokens) {
+                token.offset += static_cast<uint32_t>(segment.start - start);
+                oldTokens.push_back(token);
+            }
+            text += segment.text->view();
+            absorbed += segment.text->size();
+        }
+    };
+
+    std::string text;
+    size_t editBegin = edit.offset - start;
+    do {
+        absorb(text, 1);
+    } while (text.size() < editBegin + edit.removed);
+    text.replace(editBegin, edit.removed, edit.inserted);
+    absorb(text, 0);
+    std::shared_ptr<SourceBuffer> source = SourceBuffer::fromText(std::move(text));
+
+    /**
+     * @note The tokens that end before the edit are kept. The DFA is in the start state at the
+     *      end of the last kept token, even if a comment follows it.
+     */
+    auto tokenEnd = [](const Token& token) { return token.offset + token.value.size(); };
+    auto firstDamaged = std::ranges::partition_point(
+        oldTokens, [&](const Token& token) { return tokenEnd(token) < editBegin; });
+    std::vector<Token> tokens(oldTokens.begin(), firstDamaged);
+    size_t cur = tokens.empty() ? 0 : tokenEnd(tokens.back());
+
+    /**
+     * @note Once a new token starts after the edit at the same place as an old token, both
+     *      streams are in the start state with the same text ahead, so the old tokens from there
+     *      on are the same as what re-lexing would produce. So is the rest of the source if the
+     *      text ends in the start state, since the next segment begins where a token begins.
+     */
+    size_t editEnd = editBegin + edit.inserted.size();
+    int64_t delta = static_cast<int64_t>(edit.inserted.size()) - static_cast<int64_t>(edit.removed);
+    size_t old = firstDamaged - oldTokens.begin();
+    std::vector<Token> errors;
+    while (true) {
+        const char* begin = source->data() + cur;
+        const char* end = source->data() + source->size();
+        const char* p = begin;
+        Token token;
+        if (scanToken(*source, *document.m_interner, p, end, token)) {
+            cur = p - source->data();
+            if (token.offset >= editEnd) {
+                uint32_t oldOffset = static_cast<uint32_t>(token.offset - delta);
+                while (old != oldTokens.size() && oldTokens[old].offset < oldOffset) {
+                    ++old;
+                }
+                if (old != oldTokens.size() && oldTokens[old].offset == oldOffset) {
+                    break;
+                }
+            }
+            if (hasError(token)) {
+                errors.push_back(token);
+            }
+            tokens.push_back(token);
+            continue;
+        }
+
+        bool hasEof = false;
+        if (next != segments.size() && p == end && followComments(begin, end, false, hasEof)) {
+            // An unclosed comment goes on in the following segments, which are merged by
+            // doubling the text, so a comment that runs to the end is merged in linear time.
+            std::string grown(source->view());
+            absorb(grown, grown.size());
+            source = SourceBuffer::fromText(std::move(grown));
+            continue;
+        }
+        if (next != segments.size() && p != end) {
+            // No token follows EOF, so the rest of the source is merged without its tokens.
+            std::string grown(source->view());
+            absorb(grown, document.size());
+            source = SourceBuffer::fromText(std::move(grown));
+        }
+        old = oldTokens.size();
+        break;
     }
-    return token;
+    for (; old != oldTokens.size(); ++old) {
+        Token token = oldTokens[old];
+        token.offset = static_cast<uint32_t>(token.offset + delta);
+        tokens.push_back(token);
+    }
+
+    // Replace the merged segments, and shift the starts of the later ones.
+    size_t tokenCount = tokens.size();
+    std::vector<TokenDocument::Segment> rebuilt =
+        TokenDocument::split(source->view(), std::move(tokens), start);
+    auto replaced = segments.erase(segments.begin() + first, segments.begin() + next);
+    auto after = segments.insert(replaced, std::make_move_iterator(rebuilt.begin()),
+                                 std::make_move_iterator(rebuilt.end())) +
+                 rebuilt.size();
+    for (; after != segments.end(); ++after) {
+        after->start = static_cast<size_t>(after->start + delta);
+    }
+    document.m_size = static_cast<size_t>(document.m_size + delta);
+    document.m_tokenCount += tokenCount - oldTokens.size();
+
+    for (Token& token : errors) {
+        token.value = {source->data() + token.offset, token.value.size()};
+        reportTokenError(document.getLocation(start + token.offset), token);
+    }
+}
+
+size_t Lexer::getThreadCount() const
+{
+    if (m_threadCount != 0) {
+        return m_threadCount;
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
 }
 
-Token Lexer::getNumber()
+void Lexer::tokenizeInParallel(SourceBuffer& source, Interner& interner, TokenList& tokens,
+                               size_t threadCount) const
+{
+    const char* begin = source.data();
+    const char* end = begin + source.size();
+
+    // 1) Split the source right after a space near every 1/N of it.
+    std::vector<Chunk> chunks(threadCount);
+    const char* chunkBegin = begin;
+    for (size_t i = 0; i < threadCount; ++i) {
+        const char* chunkEnd = end;
+        if (i + 1 < threadCount) {
+            chunkEnd = std::max(begin + source.size() / threadCount * (i + 1), chunkBegin);
+            while (chunkEnd != end && !isSpaceChar(chunkEnd[-1])) {
+                ++chunkEnd;
+            }
+        }
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    // 2) Follow the comments of each chunk for both beginning states.
+    runInParallel(threadCount, [&](size_t i) {
+        Chunk& chunk = chunks[i];
+        for (int inComment = 0; inComment < 2; ++inComment) {
+            chunk.endsInComment[inComment] =
+                followComments(chunk.begin, chunk.end, inComment, chunk.hasEof[inComment]);
+        }
+    });
+
+    // 3) Resolve the beginning state of each chunk from the previous one.
+    //    The chunks after EOF are dropped.
+    bool inComment = false;
+    size_t chunkCount = chunks.size();
+    for (size_t i = 0; i < chunkCount; ++i) {
+        chunks[i].beginsInComment = inComment;
+        if (chunks[i].hasEof[inComment]) {
+            chunkCount = i + 1;
+            break;
+        }
+        inComment = chunks[i].endsInComment[inComment];
+    }
+
+    // 4) Lex the chunks with their own tables of identifiers.
+    runInParallel(chunkCount, [&](size_t i) { lexChunk(source, chunks[i]); });
+
+    // 5) Intern the identifiers of the chunks in order, so the IDs are the same as those of a
+    //    single-threaded run, and then translate the IDs of the tokens.
+    std::vector<std::vector<uint32_t>> idMaps(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const Interner& names = chunks[i].names;
+        idMaps[i].reserve(names.size());
+        for (uint32_t id = 0; id < names.size(); ++id) {
+            idMaps[i].push_back(interner.intern(names.getString(id)));
+        }
+    }
+    runInParallel(chunkCount, [&](size_t i) {
+        for (Token& token : chunks[i].tokens) {
+            if (token.type == TokenType::Identifier) {
+                token.id = idMaps[i][token.id];
+            }
+        }
+    });
+
+    // 6) Merge the chunks in order.
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        total += chunks[i].tokens.size();
+    }
+    tokens.reserve(total);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const Chunk& chunk = chunks[i];
+        size_t offset = tokens.size();
+        tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+        for (size_t index : chunk.errors) {
+            reportTokenError(source, tokens[offset + index]);
+        }
+    }
+}
+
+Token Lexer::getKeywordOrIdentifier(Scanner& scanner, Interner& interner) const
+{
+    /**
+     * @note The first character of a keyword or an identifier must be an alphabet.
+     *      For keywords, the following characters are all alphabets.
+     *      For identifiers, the following characters can be either alphabets or digits.
+     */
+    return makeWordToken(*scanner.getSource(), interner, scanner.getUntil(isAlphaOrDigit));
+}
+
+Token Lexer::getNumber(Scanner& scanner) const
 {
     /**
      * @note All the characters of a number must be digits.
      */
 
-    Token token{TokenType::Number, m_scanner->getUntil(isDigit)};
+    Token token = makeNumberToken(scanner.getUntil(isDigit));
 
     /**
      * @note If the next character is an alphabet,
      *      we treat it as an invalid identifier which begins with a digit.
      */
-    if (isAlpha(m_scanner->get())) {
-        token.type = TokenType::Invalid;
-        token.value += m_scanner->getUntil(isAlphaOrDigit);
-        Reporter::error(std::format("Invalid identifier: {}", token.value));
+    if (isAlpha(scanner.get())) {
+        std::string_view rest = scanner.getUntil(isAlphaOrDigit);
+        token = {.type = TokenType::Invalid,
+                 .value = std::string_view(token.value.data(), token.value.size() + rest.size())};
     }
     return token;
 }
 
-Token Lexer::getDelimiter()
+Token Lexer::getDelimiter(Scanner& scanner) const
 {
     /**
      * @note The delimiter is a single character.
      */
 
-    Token token = {TokenType::Delimiter, m_scanner->getAsStr()};
-    m_scanner->forward();
+    Token token{.type = TokenType::Delimiter,
+                .kind = SINGLE_CHAR_KINDS[static_cast<unsigned char>(scanner.get())],
+                .value = scanner.getAsView()};
+    scanner.forward();
     return token;
 }
 
-Token Lexer::getOperator()
+Token Lexer::getOperator(Scanner& scanner) const
 {
     /**
      * @note The operator can be a single character or a two-character sequence.
@@ -102,88 +784,40 @@ Token Lexer::getOperator()
      *     For :, it must be followed by '='. Otherwise, it is an invalid operator.
      */
 
-    Token token{TokenType::Operator, m_scanner->getAsStr()};
+    Token token{.type = TokenType::Operator, .value = scanner.getAsView()};
 
     // Check if the operator is a two-character sequence
-    m_scanner->forward();
-    char c = m_scanner->get();
+    scanner.forward();
+    char c = scanner.get();
     if (token.value == "<" || token.value == ">") {
         if (c == '=') {  // >=, <=
-            token.value += '=';
-            m_scanner->forward();
+            token.value = std::string_view(token.value.data(), 2);
+            scanner.forward();
         }
     } else if (token.value == ":") {
         if (c == '=') {  // :=
-            token.value += '=';
-            m_scanner->forward();
+            token.value = std::string_view(token.value.data(), 2);
+            scanner.forward();
         } else {
             token.type = TokenType::Invalid;
-            Reporter::error(std::format("Invalid operator: {}", token.value));
         }
     }
+    if (token.type == TokenType::Operator) {
+        token.kind = findPunctuationKind(token.value);
+    }
     return token;
 }
 
-Token Lexer::getUnknownSymbol()
+Token Lexer::getUnknownSymbol(Scanner& scanner) const
 {
-    Token token{TokenType::Invalid, m_scanner->getAsStr()};
-    Reporter::error(std::format("Unknown symbol: {}", token.value));
-    m_scanner->forward();
+    Token token{.type = TokenType::Invalid, .value = scanner.getAsView()};
+    scanner.forward();
     return token;
 }
 
-std::string Lexer::encode(const Token& token) noexcept
-{
-    switch (token.type) {
-    case TokenType::Keyword: {
-        return token.value + "sym";
-    }
-    case TokenType::Identifier: {
-        return "ident";
-    }
-    case TokenType::Number: {
-        return "number";
-    }
-    case TokenType::Operator: {
-        if (token.value == "+") {
-            return "plus";
-        } else if (token.value == "-") {
-            return "minus";
-        } else if (token.value == "*") {
-            return "times";
-        } else if (token.value == "/") {
-            return "slash";
-        } else if (token.value == "=") {
-            return "eql";
-        } else if (token.value == "#") {
-            return "neq";
-        } else if (token.value == "<") {
-            return "lss";
-        } else if (token.value == "<=") {
-            return "leq";
-        } else if (token.value == ">") {
-            return "gtr";
-        } else if (token.value == ">=") {
-            return "geq";
-        } else if (token.value == ":=") {
-            return "becomes";
-        }
-    }
-    case TokenType::Delimiter: {
-        if (token.value == "(") {
-            return "lparen";
-        } else if (token.value == ")") {
-            return "rparen";
-        } else if (token.value == ",") {
-            return "comma";
-        } else if (token.value == ";") {
-            return "semicolon";
-        } else if (token.value == ".") {
-            return "period";
-        }
-    }
-    }
-    return "nul";
+std::string_view Lexer::encode(const Token& token) noexcept
+{
+    return TOKEN_KIND_CODES[static_cast<size_t>(token.kind)];
 }
 
 }  // namespace PL0
\ No newline at end of file
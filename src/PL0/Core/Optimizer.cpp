@@ -18,30 +18,32 @@ std::vector<Quadruple> Optimizer::optimize(const std::vector<Quadruple>& quads)
             continue;
         }
 
+        auto name = [this](uint32_t id) { return std::string(m_interner->getString(id)); };
+
         Quadruple quad;
         // If the node has no operands, it is a constant or an identifier.
         // Assign the value to the FIRST NAME of the result.
         if (node->operands.empty()) {
-            quad = {"=", node->value, "", node->names[0]};
+            quad = {"=", name(node->value), "", name(node->names[0])};
         }
         // Otherwise, assign the operator and operands to the first name of the result.
         // If an operand is a constant, assign its value, otherwise assign its name.
         else {
             NodePtr operand1Node = node->operands[0];
-            std::string operand1 =
+            uint32_t operand1 =
                 operand1Node->constant.has_value() ? operand1Node->value : operand1Node->names[0];
 
             NodePtr operand2Node = node->operands[1];
-            std::string operand2 =
+            uint32_t operand2 =
                 operand2Node->constant.has_value() ? operand2Node->value : operand2Node->names[0];
 
-            quad = {node->value, operand1, operand2, node->names[0]};
+            quad = {name(node->value), name(operand1), name(operand2), name(node->names[0])};
         }
         newQuads.push_back(quad);
 
         // If there are multiple names for the result, assign the first name to other names.
         for (size_t nameIndex = 1; nameIndex < node->names.size(); ++nameIndex) {
-            Quadruple quad{"=", node->names[0], "", node->names[nameIndex]};
+            Quadruple quad{"=", name(node->names[0]), "", name(node->names[nameIndex])};
             newQuads.push_back(quad);
         }
     }
@@ -51,17 +53,24 @@ std::vector<Quadruple> Optimizer::optimize(const std::vector<Quadruple>& quads)
 
 void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
 {
-
+    /**
+     * @note The names are interned first, so the nodes are found by comparing and indexing
+     *      integers instead of strings.
+     */
     for (auto& [op, operand1, operand2, result] : quads) {
-        NodePtr node1 = nullptr;
-        bool node1Exists = m_nodePtrMap.contains(operand1);
-        if (node1Exists) {
-            node1 = m_nodePtrMap[operand1];
-        } else {
+        uint32_t opId = m_interner->intern(op);
+        uint32_t operand1Id = m_interner->intern(operand1);
+        uint32_t operand2Id = operand2.empty() ? 0 : m_interner->intern(operand2);
+        uint32_t resultId = m_interner->intern(result);
+        m_nodePtrMap.resize(m_interner->size());
+
+        NodePtr node1 = m_nodePtrMap[operand1Id];
+        bool node1Exists = node1 != nullptr;
+        if (!node1Exists) {
             // Create a new node for operand1.
             node1 = std::make_shared<DAGNode>();
-            node1->names.push_back(operand1);
-            node1->value = operand1;
+            node1->names.push_back(operand1Id);
+            node1->value = operand1Id;
             node1->constant = str2num(operand1);
         }
 
@@ -74,15 +83,13 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
          *     - Case2: (= , operand1, _, result)
          */
         if (!operand2.empty()) {  // Case1: (op, operand1, operand2, result)
-            NodePtr node2 = nullptr;
-            bool node2Exists = m_nodePtrMap.contains(operand2);
-            if (node2Exists) {
-                node2 = m_nodePtrMap[operand2];
-            } else {
+            NodePtr node2 = m_nodePtrMap[operand2Id];
+            bool node2Exists = node2 != nullptr;
+            if (!node2Exists) {
                 // Create a new node for operand2.
                 node2 = std::make_shared<DAGNode>();
-                node2->names.push_back(operand2);
-                node2->value = operand2;
+                node2->names.push_back(operand2Id);
+                node2->value = operand2Id;
                 node2->constant = str2num(operand2);
             }
 
@@ -92,20 +99,21 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
              */
             if (node1->constant.has_value() && node2->constant.has_value()) {
                 int resultVal = calculate(op, node1->constant.value(), node2->constant.value());
-                std::string resultValStr = std::to_string(resultVal);
+                uint32_t resultValId = m_interner->intern(std::to_string(resultVal));
+                m_nodePtrMap.resize(m_interner->size());
 
-                // If a node whose value is resultValStr exists, use it directly.
-                if (m_nodePtrMap.contains(resultValStr)) {
-                    curNode = m_nodePtrMap[resultValStr];
+                // If a node whose value is resultVal exists, use it directly.
+                if (m_nodePtrMap[resultValId] != nullptr) {
+                    curNode = m_nodePtrMap[resultValId];
                 }
                 // If no such node exists, create a new node for the result.
                 else {
                     curNode = std::make_shared<DAGNode>();
-                    curNode->value = resultValStr;
+                    curNode->value = resultValId;
                     curNode->names = {};
                     curNode->constant = resultVal;
                     // Add the node to the map.
-                    m_nodePtrMap[resultValStr] = curNode;
+                    m_nodePtrMap[resultValId] = curNode;
                 }
             }
             /**
@@ -118,16 +126,16 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
             else {
                 // If the nodes of operand1 and operand2 do not exist, add them to the map.
                 if (!node1Exists) {
-                    m_nodePtrMap[operand1] = node1;
+                    m_nodePtrMap[operand1Id] = node1;
                 }
                 if (!node2Exists) {
-                    m_nodePtrMap[operand2] = node2;
+                    m_nodePtrMap[operand2Id] = node2;
                 }
 
                 auto nodeIt = std::ranges::find_if(m_nodes, [&](NodePtr node) {
-                    return node->value == op && node->operands.size() == 2 &&
-                           node->operands[0] == m_nodePtrMap[operand1] &&
-                           node->operands[1] == m_nodePtrMap[operand2];
+                    return node->value == opId && node->operands.size() == 2 &&
+                           node->operands[0] == m_nodePtrMap[operand1Id] &&
+                           node->operands[1] == m_nodePtrMap[operand2Id];
                 });
                 // If the operator node exists, use it.
                 if (nodeIt != m_nodes.end()) {
@@ -137,7 +145,7 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
                 else {
                     curNode = std::make_shared<DAGNode>();
                     curNode->names = {};
-                    curNode->value = op;
+                    curNode->value = opId;
                     curNode->operands = {node1, node2};
                     curNode->constant = std::nullopt;
                 }
@@ -151,7 +159,7 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
                  *      a).
                  */
                 node1->names.pop_back();
-                m_nodePtrMap[operand1] = node1;
+                m_nodePtrMap[operand1Id] = node1;
             }
             // Use the node of operand1 as the operator node if it exists.
             curNode = node1;
@@ -160,20 +168,18 @@ void Optimizer::generateDAG(const std::vector<Quadruple>& quads)
         }
 
         // Add the name of result to the operator node.
-        curNode->names.push_back(result);
+        curNode->names.push_back(resultId);
 
         /**
          * @note If the result is already in the map, it means that its value has been updated.
          */
-        auto resultIt = m_nodePtrMap.find(result);
-        if (resultIt != m_nodePtrMap.end()) {
-            auto [_, resultNode] = *resultIt;
-            auto resultNameIt = std::ranges::find(resultNode->names, result);
+        if (const NodePtr& resultNode = m_nodePtrMap[resultId]; resultNode != nullptr) {
+            auto resultNameIt = std::ranges::find(resultNode->names, resultId);
             resultNode->names.erase(resultNameIt);
         }
 
         // Remap the result to the operator node.
-        m_nodePtrMap[result] = curNode;
+        m_nodePtrMap[resultId] = curNode;
 
         auto nodeIt = std::ranges::find(m_nodes, curNode);
         if (nodeIt == m_nodes.end()) {
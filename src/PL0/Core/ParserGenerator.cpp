@@ -0,0 +1,793 @@
+#include "PL0/Core/ParserGenerator.hpp"
+#include "PL0/Core/Action.hpp"
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <optional>
+#include <stdexcept>
+
+namespace PL0
+{
+namespace
+{
+/**
+ * @brief Append a line of code, indented by {indent} levels of 4 spaces.
+ */
+void emit(std::string& code, int indent, std::string_view text)
+{
+    if (!text.empty()) {
+        code.append(indent * 4, ' ');
+        code.append(text);
+    }
+    code += '\n';
+}
+
+/**
+ * @brief Append the items of an initializer list, wrapped before 100 columns.
+ */
+void emitList(std::string& code, int indent, const std::vector<std::string>& items)
+{
+    std::string text;
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::string item = items[i] + (i + 1 < items.size() ? "," : "};");
+        if (!text.empty() && indent * 4 + text.size() + 1 + item.size() > 100) {
+            emit(code, indent, text);
+            text.clear();
+        }
+        text += (text.empty() ? "" : " ") + item;
+    }
+    emit(code, indent, text);
+}
+
+/**
+ * @return The C++ string literal of a symbol.
+ */
+std::string quote(std::string_view text)
+{
+    std::string literal = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+        }
+        literal += c;
+    }
+    return literal + '"';
+}
+
+/**
+ * @return Whether the code uses a variable, i.e. the name appears as a word which is not a member.
+ */
+bool usesName(std::string_view code, std::string_view name)
+{
+    auto isWordChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    for (size_t pos = code.find(name); pos != std::string_view::npos;
+         pos = code.find(name, pos + 1)) {
+        size_t end = pos + name.size();
+        bool begins = pos == 0 || (!isWordChar(code[pos - 1]) && code[pos - 1] != '.');
+        bool ends = end == code.size() || !isWordChar(code[end]);
+        if (begins && ends) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @return The code to push a value to the values of an element.
+ */
+std::string push(std::string_view target, std::string_view value)
+{
+    if (target == "*syn") {
+        return std::format("syn->push_back({});", value);
+    }
+    return std::format("{}.push_back({});", target, value);
+}
+
+/**
+ * @brief How the semantic values of a rule are passed, as the table-driven parser passes them on
+ *      its analysis stack (see SemanticLL1Parser::parse).
+ * @note The value of an element goes to an element below it, which is one of the symbols after it
+ *      in the rule, or one of the elements below the rule:
+ *          - The value of a non-terminal X is passed to the element at its index offset.
+ *          - The value of "num" goes to the element right below it.
+ *          - The result of an action goes to the nearest non-terminal or synthesized value below.
+ *          - A synthesized value goes to the nearest action below.
+ *      The elements below the rule are the synthesized value of X ("*syn"), and the nearest
+ *      action below it ("outer"), which the caller passes in.
+ * @note The last non-terminal of a loop and the actions after it are kept in a frame, since they
+ *      are used after the next iteration.
+ */
+class RuleLayout
+{
+public:
+    RuleLayout(const PredictionTable& table, uint32_t rule, std::optional<size_t> loopPos)
+        : m_table(table), m_rhs(table.getRhs(rule)), m_loopPos(loopPos)
+    {
+    }
+
+    inline bool isAction(size_t pos) const
+    {
+        return !m_table.isTerminal(m_rhs[pos]) && !m_table.isNonTerminal(m_rhs[pos]);
+    }
+
+    inline bool inFrame(size_t pos) const
+    {
+        return m_loopPos && pos >= *m_loopPos;
+    }
+
+    std::string inhOf(size_t pos) const
+    {
+        return inFrame(pos) ? "frame.inh" : std::format("inh{}", pos);
+    }
+
+    std::string synOf(size_t pos) const
+    {
+        return inFrame(pos) ? "frame.synValue" : std::format("syn{}", pos);
+    }
+
+    std::string operandsOf(size_t pos) const
+    {
+        return inFrame(pos) ? std::format("frame.actions[{}]", pos - *m_loopPos - 1)
+                            : std::format("action{}", pos);
+    }
+
+    /**
+     * @return A pointer to the nearest action after {pos}, or "outer".
+     */
+    std::string actionAfter(size_t pos) const
+    {
+        std::optional<size_t> action = findActionAfter(pos);
+        return action ? "&" + operandsOf(*action) : "outer";
+    }
+
+    /**
+     * @return The nearest non-terminal after {pos}, or "*syn".
+     */
+    std::string nonTerminalAfter(size_t pos) const
+    {
+        for (size_t i = pos + 1; i < m_rhs.size(); ++i) {
+            if (m_table.isNonTerminal(m_rhs[i])) {
+                return inhOf(i);
+            }
+        }
+        return "*syn";
+    }
+
+    /**
+     * @return The element right below {pos}, or std::nullopt if it is a terminal, whose values
+     *      are never used.
+     */
+    std::optional<std::string> elementBelow(size_t pos) const
+    {
+        if (pos + 1 == m_rhs.size()) {
+            return "*syn";
+        } else if (m_table.isNonTerminal(m_rhs[pos + 1])) {
+            return inhOf(pos + 1);
+        } else if (isAction(pos + 1)) {
+            return operandsOf(pos + 1);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @return The element at an index offset from the left-hand side, or std::nullopt if it is a
+     *      terminal.
+     * @throw std::runtime_error If the offset is out of the rule.
+     */
+    std::optional<std::string> elementAt(int indexOffset) const
+    {
+        // The symbols are pushed in reverse order, and a non-terminal is pushed after its
+        // synthesized value.
+        int index = 0;
+        for (size_t pos = m_rhs.size(); pos-- > 0;) {
+            bool nonTerminal = m_table.isNonTerminal(m_rhs[pos]);
+            if (nonTerminal && index == indexOffset) {
+                return synOf(pos);
+            }
+            index += nonTerminal ? 1 : 0;
+            if (index == indexOffset) {
+                if (nonTerminal) {
+                    return inhOf(pos);
+                }
+                return isAction(pos) ? std::optional(operandsOf(pos)) : std::nullopt;
+            }
+            ++index;
+        }
+        throw std::runtime_error(
+            std::format("The index offset {} is out of the right-hand side", indexOffset));
+    }
+
+    /**
+     * @return The position of the nearest action after {pos}, if any.
+     */
+    std::optional<size_t> findActionAfter(size_t pos) const
+    {
+        for (size_t i = pos + 1; i < m_rhs.size(); ++i) {
+            if (isAction(i)) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    const PredictionTable& m_table;
+    std::span<const SymbolId> m_rhs;
+    std::optional<size_t> m_loopPos;
+};
+}  // namespace
+
+ParserGenerator::ParserGenerator(const ParseTables& tables)
+    : m_table(tables.predictionTable), m_indexOffsets(tables.indexOffsets),
+      m_actionFuncs(m_table.getSymbolCount()),
+      m_semantic(m_table.getSymbolCount() >
+                 m_table.getTerminalCount() + m_table.getNonTerminalCount())
+{
+    for (const auto& [actionSym, function] : tables.actions) {
+        if (!Action::find(function)) {
+            throw std::runtime_error(std::format("Action function {} does not exist", function));
+        }
+        SymbolId id = m_table.findSymbol(actionSym);
+        if (id == PredictionTable::NO_SYMBOL) {
+            throw std::runtime_error(std::format("Action {} does not exist", actionSym));
+        }
+        m_actionFuncs[id] = function;
+    }
+    for (size_t id = m_table.getTerminalCount() + m_table.getNonTerminalCount();
+         id < m_table.getSymbolCount(); ++id) {
+        if (m_actionFuncs[id].empty()) {
+            throw std::runtime_error(std::format("Action {} has no function",
+                                                 m_table.getName(static_cast<SymbolId>(id))));
+        }
+    }
+
+    // A function is named after its non-terminal, e.g. parseEPrime for E'.
+    for (size_t i = 0; i < m_table.getNonTerminalCount(); ++i) {
+        SymbolId nonTerminal = static_cast<SymbolId>(m_table.getTerminalCount() + i);
+        std::string name = "parse";
+        for (char c : m_table.getName(nonTerminal)) {
+            name += isAlphaOrDigit(c) ? std::string(1, c) : c == '\'' ? "Prime" : "_";
+        }
+        if (std::ranges::find(m_functionNames, name) != m_functionNames.end()) {
+            name += std::to_string(i);
+        }
+        m_functionNames.push_back(name);
+    }
+
+    // The left-hand side of a rule is the row of the table it is predicted in.
+    m_ruleLhs.assign(m_table.getRuleCount(), PredictionTable::NO_SYMBOL);
+    for (size_t i = 0; i < m_table.getNonTerminalCount(); ++i) {
+        SymbolId nonTerminal = static_cast<SymbolId>(m_table.getTerminalCount() + i);
+        for (SymbolId terminal = 0; terminal < m_table.getTerminalCount(); ++terminal) {
+            uint32_t rule = m_table.predict(nonTerminal, terminal);
+            if (rule != PredictionTable::NO_RULE) {
+                m_ruleLhs[rule] = nonTerminal;
+            }
+        }
+    }
+
+    // The index offsets are resolved now, so a bad one is an error of the grammar.
+    for (uint32_t rule = 0; rule < m_table.getRuleCount(); ++rule) {
+        if (m_semantic && m_indexOffsets[rule] != NULL_OFFSET) {
+            RuleLayout(m_table, rule, std::nullopt).elementAt(m_indexOffsets[rule]);
+        }
+    }
+}
+
+std::string ParserGenerator::getFunctionName(SymbolId nonTerminal) const
+{
+    return m_functionNames[nonTerminal - m_table.getTerminalCount()];
+}
+
+
+std::optional<size_t> ParserGenerator::getLoopPos(uint32_t rule) const
+{
+    std::span<const SymbolId> rhs = m_table.getRhs(rule);
+    for (size_t pos = rhs.size(); pos-- > 0;) {
+        if (m_table.isTerminal(rhs[pos])) {
+            return std::nullopt;
+        } else if (m_table.isNonTerminal(rhs[pos])) {
+            return rhs[pos] == m_ruleLhs[rule] ? std::optional(pos) : std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string ParserGenerator::getRuleText(uint32_t rule) const
+{
+    std::string text = std::string(m_table.getName(m_ruleLhs[rule])) + " ->";
+    std::span<const SymbolId> rhs = m_table.getRhs(rule);
+    if (std::ranges::none_of(rhs, [this](SymbolId sym) {
+            return m_table.isTerminal(sym) || m_table.isNonTerminal(sym);
+        })) {
+        text += " ε";
+    }
+    for (SymbolId sym : rhs) {
+        text += m_table.isTerminal(sym) || m_table.isNonTerminal(sym)
+                    ? std::format(" {}", m_table.getName(sym))
+                    : std::format(" {{{}}}", m_table.getName(sym));
+    }
+    return text;
+}
+
+std::string ParserGenerator::generate(std::string_view className,
+                                      std::string_view grammarName) const
+{
+    const PredictionTable& table = m_table;
+    const size_t terminalCount = table.getTerminalCount();
+    std::string code;
+    auto line = [&code](int indent, std::string_view text) { emit(code, indent, text); };
+
+    // The frames of the loops hold the operands of the actions after the last non-terminal.
+    size_t frameActionCount = 0;
+    bool hasLoop = false;
+    for (uint32_t rule = 0; rule < table.getRuleCount(); ++rule) {
+        if (std::optional<size_t> loopPos = getLoopPos(rule)) {
+            hasLoop = true;
+            frameActionCount = std::max(frameActionCount, table.getRhs(rule).size() - *loopPos - 1);
+        }
+    }
+    bool hasFrames = m_semantic && hasLoop;
+
+    line(0, std::format("// Generated by rdgen from {}. Do not edit.", grammarName));
+    line(0, "#pragma once");
+    line(0, "#include \"PL0/Core/Action.hpp\"");
+    line(0, "#include \"PL0/Core/Parser.hpp\"");
+    line(0, "#include \"PL0/Core/Symbol.hpp\"");
+    line(0, "#include \"PL0/Utils/Error.hpp\"");
+    line(0, "#include \"PL0/Utils/Reporter.hpp\"");
+    line(0, "#include <array>");
+    line(0, "#include <cstdint>");
+    if (hasFrames) {
+        line(0, "#include <deque>");
+    }
+    line(0, "#include <format>");
+    line(0, "#include <optional>");
+    line(0, "#include <span>");
+    line(0, "#include <string_view>");
+    line(0, "#include <vector>");
+    line(0, "");
+    line(0, "namespace PL0::Generated");
+    line(0, "{");
+    line(0, "/**");
+    line(0, std::format(" * @brief The recursive-descent parser of {}.", grammarName));
+    line(0, std::format(" * @note It parses like {}, by the same SELECT sets, but each",
+                        m_semantic ? "SemanticLL1Parser" : "LL1Parser"));
+    line(0, " *      non-terminal is a function which switches on the lookahead terminal.");
+    line(0, " */");
+    line(0, std::format("class {} : public Parser", className));
+    line(0, "{");
+    line(0, "public:");
+    line(1, "using Parser::parse;");
+    line(0, "");
+    line(1, "virtual void parse(TokenSource& tokens) const override");
+    line(1, "{");
+    line(2, "Context context(tokens);");
+    line(2, "try {");
+    line(3, "context.next();");
+    SymbolId beginSym = table.getBeginSym();
+    if (m_semantic) {
+        line(3, "Values inh, syn;");
+        line(3, std::format("context.{}(&inh, &syn, nullptr);", getFunctionName(beginSym)));
+    } else {
+        line(3, std::format("context.{}();", getFunctionName(beginSym)));
+    }
+    line(3, "if (context.lookahead != END) {");
+    line(4, std::format("context.mismatch({});", quote(ENDSYM)));
+    line(3, "}");
+    line(2, "} catch (const SyntaxError& e) {");
+    line(3, "Reporter::error(e.what());");
+    line(3, "return;");
+    if (m_semantic) {
+        line(2, "} catch (const SemanticError& e) {");
+        line(3, "Reporter::error(e.what());");
+        line(3, "return;");
+    }
+    line(2, "}");
+    line(2, m_semantic ? "Reporter::success(\"Syntax and semantics correct.\");"
+                       : "Reporter::success(\"Syntax correct.\");");
+    line(1, "}");
+    line(0, "");
+    line(0, "private:");
+    if (m_semantic) {
+        line(1, "/**");
+        line(1, " * @brief The values passed to an element, inline unless there are many.");
+        line(1, " */");
+        line(1, "class Values");
+        line(1, "{");
+        line(1, "public:");
+        line(2, "void push_back(int value)");
+        line(2, "{");
+        line(3, "if (m_size < INLINE_CAPACITY) {");
+        line(4, "m_inline[m_size] = value;");
+        line(3, "} else {");
+        line(4, "if (m_size == INLINE_CAPACITY) {");
+        line(5, "m_spilled.assign(m_inline.begin(), m_inline.end());");
+        line(4, "}");
+        line(4, "m_spilled.push_back(value);");
+        line(3, "}");
+        line(3, "++m_size;");
+        line(2, "}");
+        line(0, "");
+        line(2, "size_t size() const");
+        line(2, "{");
+        line(3, "return m_size;");
+        line(2, "}");
+        line(0, "");
+        line(2, "int operator[](size_t i) const");
+        line(2, "{");
+        line(3, "return data()[i];");
+        line(2, "}");
+        line(0, "");
+        line(2, "operator std::span<const int>() const");
+        line(2, "{");
+        line(3, "return {data(), m_size};");
+        line(2, "}");
+        line(0, "");
+        line(1, "private:");
+        line(2, "static constexpr size_t INLINE_CAPACITY = 4;");
+        line(0, "");
+        line(2, "const int* data() const");
+        line(2, "{");
+        line(3, "return m_size <= INLINE_CAPACITY ? m_inline.data() : m_spilled.data();");
+        line(2, "}");
+        line(0, "");
+        line(2, "std::array<int, INLINE_CAPACITY> m_inline;");
+        line(2, "std::vector<int> m_spilled;");
+        line(2, "size_t m_size = 0;");
+        line(1, "};");
+        line(0, "");
+    }
+    line(1, std::format("static constexpr uint32_t END = {};", table.getEndSym()));
+    line(1, std::format("static constexpr uint32_t NO_TERMINAL = {};", terminalCount));
+    line(1, std::format("static constexpr size_t MAX_DEPTH = {};", MAX_DEPTH));
+    line(0, "");
+
+    std::vector<std::string> names;
+    for (SymbolId terminal = 0; terminal < terminalCount; ++terminal) {
+        names.push_back(quote(table.getName(terminal)));
+    }
+    line(1, std::format("static constexpr std::array<std::string_view, {}> TERMINAL_NAMES = {{",
+                        terminalCount));
+    emitList(code, 2, names);
+    line(0, "");
+
+    // Every word is an identifier to a grammar with actions, as SemanticLL1Parser translates it.
+    const auto& kindSymbols = m_semantic ? EXPRESSION_SYMBOLS : TOKEN_KIND_SYMBOLS;
+    std::vector<std::string> kinds;
+    for (size_t kind = 0; kind < TOKEN_KIND_COUNT; ++kind) {
+        SymbolId terminal = table.findSymbol(kindSymbols[kind]);
+        kinds.push_back(std::to_string(table.isTerminal(terminal) ? terminal : terminalCount));
+    }
+    line(1, "// The terminal of each token kind, or NO_TERMINAL.");
+    line(1, "static constexpr std::array<uint32_t, TOKEN_KIND_COUNT> KIND_TERMINALS = {");
+    emitList(code, 2, kinds);
+    line(0, "");
+
+    if (hasFrames) {
+        line(1, "/**");
+        line(1, " * @brief An iteration of a loop, whose last non-terminal is parsed by the next.");
+        line(1, " */");
+        line(1, "struct Frame");
+        line(1, "{");
+        line(2, "uint32_t rule;");
+        line(2, "Values* syn;       // The synthesized value of the left-hand side.");
+        line(2, "Values* outer;     // The action below the left-hand side.");
+        line(2, "Values inh;        // The value of the last non-terminal.");
+        line(2, "Values synValue;   // The synthesized value of the last non-terminal.");
+        line(2, std::format("std::array<Values, {}> actions;  // The actions after it.",
+                            frameActionCount));
+        line(1, "};");
+        line(0, "");
+    }
+
+    line(1, "/**");
+    line(1, " * @brief The state of a parse, with a function to parse each non-terminal.");
+    line(1, " */");
+    line(1, "struct Context");
+    line(1, "{");
+    line(2, "TokenSource& tokens;");
+    line(2, "Token token{};");
+    line(2, "uint32_t lookahead = NO_TERMINAL;");
+    line(2, "uint32_t offset = NO_OFFSET;  // The offset of the lookahead token, if any.");
+    line(2, "size_t depth = 0;");
+    if (hasFrames) {
+        line(2, "std::deque<Frame> frames;");
+    }
+    line(0, "");
+    line(2, "explicit Context(TokenSource& tokens) : tokens(tokens)");
+    line(2, "{");
+    line(2, "}");
+    line(0, "");
+    line(2, "void next()");
+    line(2, "{");
+    line(3, "if (!tokens.next(token)) {");
+    line(4, "lookahead = END;");
+    line(4, "offset = NO_OFFSET;");
+    line(4, "return;");
+    line(3, "}");
+    line(3, "offset = token.offset;");
+    if (m_semantic) {
+        line(3, "if (token.type != TokenType::Invalid) {");
+        line(4, "lookahead = KIND_TERMINALS[static_cast<size_t>(token.kind)];");
+        line(3, "} else {");
+        line(4, "lookahead = findTerminal(translateExpressionSymbol(token));");
+        line(3, "}");
+    } else {
+        line(3, "lookahead = KIND_TERMINALS[static_cast<size_t>(token.kind)];");
+    }
+    line(2, "}");
+    line(0, "");
+    if (m_semantic) {
+        line(2, "static uint32_t findTerminal(std::string_view name)");
+        line(2, "{");
+        line(3, "for (uint32_t terminal = 0; terminal < NO_TERMINAL; ++terminal) {");
+        line(4, "if (TERMINAL_NAMES[terminal] == name) {");
+        line(5, "return terminal;");
+        line(4, "}");
+        line(3, "}");
+        line(3, "return NO_TERMINAL;");
+        line(2, "}");
+        line(0, "");
+    }
+    line(2, "std::string_view lookaheadName() const");
+    line(2, "{");
+    line(3, std::format("return offset != NO_OFFSET ? {}(token) : std::string_view(ENDSYM);",
+                        m_semantic ? "translateExpressionSymbol" : "translate2Symbol"));
+    line(2, "}");
+    line(0, "");
+    line(2, "[[noreturn]] void mismatch(std::string_view expected) const");
+    line(2, "{");
+    line(3, "throw SyntaxError(std::format(");
+    line(4, "\"{}The terminal symbol {} does not match the top of the input stack {}.\",");
+    line(4, "locate(tokens, offset), expected, lookaheadName()));");
+    line(2, "}");
+    line(0, "");
+    line(2, "[[noreturn]] void notAllowed() const");
+    line(2, "{");
+    line(3, "throw SyntaxError(");
+    line(4, "std::format(\"{}{} is not allowed.\", locate(tokens, offset), lookaheadName()));");
+    line(2, "}");
+    line(0, "");
+    line(2, "void match(uint32_t terminal)");
+    line(2, "{");
+    line(3, "if (lookahead != terminal) {");
+    line(4, "mismatch(TERMINAL_NAMES[terminal]);");
+    line(3, "}");
+    line(3, "next();");
+    line(2, "}");
+    line(0, "");
+    line(2, "void enter()");
+    line(2, "{");
+    line(3, "if (++depth > MAX_DEPTH) {");
+    line(4, "throw SyntaxError(locate(tokens, offset) + \"The input is nested too deeply.\");");
+    line(3, "}");
+    line(2, "}");
+    for (size_t i = 0; i < table.getNonTerminalCount(); ++i) {
+        line(0, "");
+        generateFunction(code, static_cast<SymbolId>(terminalCount + i));
+    }
+    line(1, "};");
+    line(0, "};");
+    line(0, "}  // namespace PL0::Generated");
+    return code;
+}
+
+void ParserGenerator::generateFunction(std::string& code, SymbolId nonTerminal) const
+{
+    const PredictionTable& table = m_table;
+    std::string body;  // The parameters are declared once the body tells which ones it uses.
+    auto line = [&body](int indent, std::string_view text) { emit(body, indent, text); };
+
+    // The rules of the non-terminal, and the terminals which select each of them.
+    using Case = std::pair<uint32_t, std::vector<SymbolId>>;
+    std::vector<Case> cases;
+    for (SymbolId terminal = 0; terminal < table.getTerminalCount(); ++terminal) {
+        uint32_t rule = table.predict(nonTerminal, terminal);
+        if (rule == PredictionTable::NO_RULE) {
+            continue;
+        }
+        auto it = std::ranges::find(cases, rule, &Case::first);
+        if (it == cases.end()) {
+            cases.push_back({rule, {}});
+            it = cases.end() - 1;
+        }
+        it->second.push_back(terminal);
+    }
+    std::ranges::sort(cases);
+    bool hasLoop = std::ranges::any_of(cases, [this](const auto& c) {
+        return getLoopPos(c.first).has_value();
+    });
+    bool hasFrames = m_semantic && hasLoop;
+
+    line(2, "{");
+    line(3, "enter();");
+    if (hasFrames) {
+        line(3, "size_t base = frames.size();");
+    }
+    int indent = 3;
+    if (hasLoop) {
+        line(3, "for (;;) {");
+        indent = 4;
+    }
+    line(indent, "switch (lookahead) {");
+    for (const auto& [rule, terminals] : cases) {
+        for (size_t i = 0; i < terminals.size(); ++i) {
+            line(indent, std::format("case {}:{}  // {}", terminals[i],
+                                     i + 1 == terminals.size() ? " {" : "",
+                                     table.getName(terminals[i])));
+        }
+        generateRule(body, indent + 1, rule);
+        line(indent, "}");
+    }
+    line(indent, "default:");
+    line(indent + 1, "notAllowed();");
+    line(indent, "}");
+    if (hasLoop) {
+        line(4, "break;");
+        line(3, "}");
+    }
+    if (hasFrames) {
+        line(0, "");
+        line(3, "// Finish the iterations from the last one.");
+        line(3, "while (frames.size() > base) {");
+        line(4, "Frame& frame = frames.back();");
+        line(4, "switch (frame.rule) {");
+        for (const auto& c : cases) {
+            if (getLoopPos(c.first)) {
+                generateUnwind(body, 4, c.first);
+            }
+        }
+        line(4, "}");
+        line(4, "frames.pop_back();");
+        line(3, "}");
+    }
+    line(3, "--depth;");
+    line(2, "}");
+
+    // The names of the unused parameters are left out, so the code compiles without warnings.
+    std::string params;
+    if (m_semantic) {
+        for (std::string_view name : {"inh", "syn", "outer"}) {
+            params += params.empty() ? "Values*" : ", Values*";
+            if (usesName(body, name)) {
+                params += ' ';
+                params += name;
+            }
+        }
+    }
+    emit(code, 2, std::format("// {}", table.getName(nonTerminal)));
+    emit(code, 2, std::format("void {}({})", getFunctionName(nonTerminal), params));
+    code += body;
+}
+
+void ParserGenerator::generateRule(std::string& code, int indent, uint32_t rule) const
+{
+    const PredictionTable& table = m_table;
+    auto line = [&code, indent](int extra, std::string_view text) {
+        emit(code, indent + extra, text);
+    };
+    std::span<const SymbolId> rhs = table.getRhs(rule);
+    std::optional<size_t> loopPos = getLoopPos(rule);
+    RuleLayout layout(table, rule, loopPos);
+    size_t end = loopPos.value_or(rhs.size());
+
+    line(0, "// " + getRuleText(rule));
+    if (m_semantic) {
+        if (loopPos) {
+            line(0, "Frame& frame = frames.emplace_back();");
+            line(0, std::format("frame.rule = {};", rule));
+            line(0, "frame.syn = syn;");
+            line(0, "frame.outer = outer;");
+        }
+        std::string locals;
+        for (size_t pos = 0; pos < end; ++pos) {
+            if (table.isNonTerminal(rhs[pos])) {
+                locals += std::format("{}inh{}, syn{}", locals.empty() ? "" : ", ", pos, pos);
+            } else if (layout.isAction(pos)) {
+                locals += std::format("{}action{}", locals.empty() ? "" : ", ", pos);
+            }
+        }
+        if (!locals.empty()) {
+            line(0, std::format("Values {};", locals));
+        }
+        if (m_indexOffsets[rule] != NULL_OFFSET) {
+            if (std::optional<std::string> target = layout.elementAt(m_indexOffsets[rule])) {
+                line(0, "if (inh->size() == 1) {");
+                line(1, push(*target, "(*inh)[0]"));
+                line(0, "}");
+            }
+        }
+    }
+
+    for (size_t pos = 0; pos < end; ++pos) {
+        SymbolId sym = rhs[pos];
+        std::string_view name = table.getName(sym);
+        if (table.isTerminal(sym)) {
+            // The first terminal of a rule is the lookahead which selects the rule.
+            bool matched = pos == 0;
+            if (!m_semantic || (name != "id" && name != "num")) {
+                line(0, matched ? std::format("next();  // {}", name)
+                                : std::format("match({});  // {}", sym, name));
+                continue;
+            }
+            if (!matched) {
+                line(0, std::format("if (lookahead != {}) {{", sym));
+                line(1, std::format("mismatch({});", quote(name)));
+                line(0, "}");
+            }
+            if (name == "id") {
+                // Values of identifiers are unknown, so the result cannot be calculated.
+                line(0, "throw SemanticError(locate(tokens, offset) +");
+                line(0, "                    \"Identifier is not allowed in the expression.\");");
+                return;
+            }
+            line(0, "if (token.outOfRange) {");
+            line(1, "throw SemanticError(locate(tokens, offset) + \"Number out of range.\");");
+            line(0, "}");
+            if (std::optional<std::string> target = layout.elementBelow(pos)) {
+                line(0, push(*target, "getNumberValue(token)"));
+            }
+            line(0, "next();");
+        } else if (table.isNonTerminal(sym)) {
+            if (!m_semantic) {
+                line(0, std::format("{}();", getFunctionName(sym)));
+                continue;
+            }
+            std::string outer = layout.actionAfter(pos);
+            line(0, std::format("{}(&inh{}, &syn{}, {});", getFunctionName(sym), pos, pos, outer));
+            if (outer == "outer") {
+                line(0, std::format("if (syn{}.size() == 1 && outer) {{", pos));
+                line(1, std::format("outer->push_back(syn{}[0]);", pos));
+            } else {
+                line(0, std::format("if (syn{}.size() == 1) {{", pos));
+                line(1, push(outer.substr(1), std::format("syn{}[0]", pos)));
+            }
+            line(0, "}");
+        } else {
+            std::string call =
+                std::format("Action::{}({})", m_actionFuncs[sym], layout.operandsOf(pos));
+            line(0, push(layout.nonTerminalAfter(pos), call));
+        }
+    }
+
+    if (!loopPos) {
+        line(0, "break;");
+        return;
+    }
+    // The last non-terminal is parsed by the next iteration, in the frame.
+    if (m_semantic) {
+        line(0, "inh = &frame.inh;");
+        line(0, "syn = &frame.synValue;");
+        if (std::string outer = layout.actionAfter(*loopPos); outer != "outer") {
+            line(0, std::format("outer = {};", outer));
+        }
+    }
+    line(0, "continue;");
+}
+
+void ParserGenerator::generateUnwind(std::string& code, int indent, uint32_t rule) const
+{
+    auto line = [&code, indent](int extra, std::string_view text) {
+        emit(code, indent + extra, text);
+    };
+    std::span<const SymbolId> rhs = m_table.getRhs(rule);
+    size_t loopPos = *getLoopPos(rule);
+
+    line(0, std::format("case {}: {{  // {}", rule, getRuleText(rule)));
+    if (loopPos + 1 < rhs.size()) {
+        line(1, "if (frame.synValue.size() == 1) {");
+        line(2, "frame.actions[0].push_back(frame.synValue[0]);");
+    } else {
+        line(1, "if (frame.synValue.size() == 1 && frame.outer) {");
+        line(2, "frame.outer->push_back(frame.synValue[0]);");
+    }
+    line(1, "}");
+    for (size_t pos = loopPos + 1; pos < rhs.size(); ++pos) {
+        line(1, std::format("frame.syn->push_back(Action::{}(frame.actions[{}]));",
+                            m_actionFuncs[rhs[pos]], pos - loopPos - 1));
+    }
+    line(1, "break;");
+    line(0, "}");
+}
+}  // namespace PL0
@@ -0,0 +1,322 @@
+#include "PL0/Core/PrattParser.hpp"
+#include "PL0/Core/Action.hpp"
+#include "PL0/Core/Symbol.hpp"
+#include "PL0/Utils/Error.hpp"
+#include "PL0/Utils/Reporter.hpp"
+#include <algorithm>
+#include <array>
+#include <format>
+#include <vector>
+
+namespace PL0
+{
+namespace
+{
+/**
+ * @brief A binary operator: the node it builds, the action which computes its value, and how
+ *      tightly it binds. The precedence of any other token is 0.
+ */
+struct BinaryOperator
+{
+    uint8_t precedence;
+    NodeKind kind;
+    Action::Function action;
+};
+
+constexpr std::array<BinaryOperator, TOKEN_KIND_COUNT> BINARY_OPERATORS = [] {
+    std::array<BinaryOperator, TOKEN_KIND_COUNT> operators{};
+    operators[static_cast<size_t>(TokenKind::Plus)] = {1, NodeKind::Add, Action::add};
+    operators[static_cast<size_t>(TokenKind::Minus)] = {1, NodeKind::Sub, Action::sub};
+    operators[static_cast<size_t>(TokenKind::Times)] = {3, NodeKind::Mul, Action::mul};
+    operators[static_cast<size_t>(TokenKind::Slash)] = {3, NodeKind::Div, Action::div};
+    return operators;
+}();
+
+/**
+ * @note In Mode::Syntax, a sign binds tighter than + and -, but looser than * and /, so the tree
+ *      of "-a * b" is Neg(Mul(a, b)) as ExpressionBuilder builds it. In Mode::Semantics, a sign
+ *      applies to the whole expression, and its node is built when the expression ends.
+ */
+constexpr uint8_t SIGN_PRECEDENCE = 2;
+}  // namespace
+
+/**
+ * @brief The state of one parse: the token source, the lookahead token, the stack of pending
+ *      operators and the value of the last operand.
+ * @tparam SEMANTICS Whether the tokens are taken as SemanticLL1Parser takes them, and the values
+ *      are computed.
+ */
+template <bool SEMANTICS>
+class PrattParser::Context
+{
+public:
+    /**
+     * @param unit The compilation unit to build the tree in, or nullptr to build no tree.
+     */
+    Context(TokenSource& tokens, CompilationUnit* unit) : m_tokens(tokens), m_unit(unit)
+    {
+        advance();
+    }
+
+    /**
+     * @return The root of the tree of the expression, or NO_NODE if no tree is built.
+     * @note The input is read in two alternating states: before an operand, which may be a
+     *      parenthesized expression, and after it, where the operator after the operand decides
+     *      which pending operators are reduced.
+     */
+    NodeId expression()
+    {
+        m_frames.push_back({NodeKind::Empty, 0, false, 0, mark(), nullptr, 0});  // The whole input
+        bool begins = true;  // Whether an expression begins, where a sign is allowed.
+        while (true) {
+            // Before an operand
+            if (begins && (m_kind == TokenKind::Plus || m_kind == TokenKind::Minus)) {
+                if (m_kind == TokenKind::Minus) {
+                    m_frames.back().negative = true;
+                    if constexpr (SEMANTICS) {
+                        m_frames.back().offset = m_token.offset;
+                    } else {
+                        m_frames.push_back({NodeKind::Neg, SIGN_PRECEDENCE, false,
+                                            m_token.offset, mark(), nullptr, 0});
+                    }
+                }
+                advance();
+            }
+            if (m_kind == TokenKind::LParen) {
+                m_frames.push_back(
+                    {NodeKind::Empty, 0, false, m_token.offset, mark(), nullptr, 0});
+                advance();
+                begins = true;
+                continue;
+            }
+            operand();
+
+            // After an operand
+            while (true) {
+                const BinaryOperator& op = BINARY_OPERATORS[static_cast<size_t>(m_kind)];
+                reduce(std::max<uint8_t>(op.precedence, 1));
+                if (op.precedence > 0) {
+                    m_frames.push_back({op.kind, op.precedence, false, m_token.offset,
+                                        m_lastBegin, op.action, m_value});
+                    advance();
+                    break;
+                }
+
+                // The expression ends, which only ) or the end of the input may follow.
+                if (!m_atEnd && m_kind != TokenKind::RParen) {
+                    throw notAllowed();
+                }
+                Frame open = m_frames.back();
+                m_frames.pop_back();
+                if constexpr (SEMANTICS) {
+                    if (open.negative) {  // E -> - E' {2}: the sign applies to the whole sum.
+                        node(NodeKind::Neg, open.offset, open.begin);
+                        m_value = Action::opposite({&m_value, 1});
+                    }
+                }
+                if (m_frames.empty()) {
+                    if constexpr (SEMANTICS) {
+                        Action::print({&m_value, 1});
+                    }
+                    if (!m_atEnd) {
+                        throw mismatch(ENDSYM);
+                    }
+                    return m_unit ? m_unit->getNodeCount() - 1 : NO_NODE;
+                }
+                if (m_atEnd) {
+                    throw mismatch(")");
+                }
+                m_lastBegin = open.begin;
+                advance();
+            }
+            begins = false;
+        }
+    }
+
+private:
+    /**
+     * @brief A pending operator, or an open parenthesis.
+     */
+    struct Frame
+    {
+        NodeKind kind;            // Empty for an open parenthesis or the whole input.
+        uint8_t precedence;       // 0 for an open parenthesis or the whole input.
+        bool negative;            // Whether the expression in the parentheses begins with -.
+        uint32_t offset;          // The offset of the operator, or of the sign of a negative
+                                  // expression in Mode::Semantics.
+        NodeId begin;             // The first node of the subtree.
+        Action::Function action;  // The action of a binary operator.
+        int value;                // The value of the left operand of a binary operator.
+    };
+
+    /**
+     * @brief Match an identifier or a number.
+     */
+    void operand()
+    {
+        switch (m_kind) {
+        case TokenKind::Ident:
+            if constexpr (SEMANTICS) {
+                // Values of identifiers are unknown, so the result cannot be calculated.
+                throw SemanticError(locate() + "Identifier is not allowed in the expression.");
+            }
+            m_lastBegin = leaf(NodeKind::Ident, m_token.id);
+            break;
+        case TokenKind::Number:
+            if constexpr (SEMANTICS) {
+                if (m_token.outOfRange) {
+                    throw SemanticError(locate() + "Number out of range.");
+                }
+                m_value = getNumberValue(m_token);
+            }
+            m_lastBegin = leaf(NodeKind::Number, static_cast<uint32_t>(getNumberValue(m_token)));
+            break;
+        default:
+            throw notAllowed();
+        }
+        advance();
+    }
+
+    /**
+     * @brief Pop the operators of at least {precedence}, build their nodes and compute their
+     *      values.
+     * @note An operator is reduced as soon as its right operand is complete, before the lookahead
+     *      is checked, so the semantic errors precede the syntax errors as in SemanticLL1Parser,
+     *      e.g. for "1 / 0 x".
+     */
+    void reduce(uint8_t precedence)
+    {
+        while (m_frames.back().precedence >= precedence) {
+            const Frame& op = m_frames.back();
+            node(op.kind, op.offset, op.begin);
+            m_lastBegin = op.begin;
+            if constexpr (SEMANTICS) {
+                std::array<int, 2> operands = {op.value, m_value};
+                m_value = op.action(operands);
+            }
+            m_frames.pop_back();
+        }
+    }
+
+private:
+    NodeId mark() const
+    {
+        return m_unit ? m_unit->getNodeCount() : NO_NODE;
+    }
+
+    NodeId leaf(NodeKind kind, uint32_t value)
+    {
+        return m_unit ? m_unit->addLeaf(kind, m_token.offset, value) : NO_NODE;
+    }
+
+    NodeId node(NodeKind kind, uint32_t offset, NodeId begin)
+    {
+        return m_unit ? m_unit->addNode(kind, offset, begin) : NO_NODE;
+    }
+
+private:
+    /**
+     * @brief Move the lookahead to the next token, and translate its kind as the grammar takes
+     *      it. Once the source is exhausted, the kind is TokenKind::Nul.
+     * @note LL1Parser only takes the operators, the parentheses, identifiers and numbers, while
+     *      SemanticLL1Parser takes keywords as identifiers, and invalid tokens by their first
+     *      character (see translateExpressionSymbol).
+     */
+    void advance()
+    {
+        if (!m_tokens.next(m_token)) {
+            m_kind = TokenKind::Nul;
+            m_atEnd = true;
+        } else if (m_token.type != TokenType::Invalid) {
+            bool keyword = m_token.kind >= TokenKind::Const;
+            m_kind = !keyword ? m_token.kind : SEMANTICS ? TokenKind::Ident : TokenKind::Nul;
+        } else if constexpr (SEMANTICS) {
+            std::string_view symbol = translateExpressionSymbol(m_token);
+            m_kind = symbol == "num"  ? TokenKind::Number
+                     : symbol == "id" ? TokenKind::Ident
+                                      : findPunctuationKind(symbol);
+        } else {
+            m_kind = TokenKind::Nul;
+        }
+    }
+
+    std::string locate() const
+    {
+        return Parser::locate(m_tokens, m_atEnd ? NO_OFFSET : m_token.offset);
+    }
+
+    std::string_view getLookaheadName() const
+    {
+        if (m_atEnd) {
+            return ENDSYM;
+        }
+        return SEMANTICS ? translateExpressionSymbol(m_token) : translate2Symbol(m_token);
+    }
+
+    /**
+     * @brief The error where no rule predicts the lookahead.
+     */
+    SyntaxError notAllowed() const
+    {
+        return SyntaxError(std::format("{}{} is not allowed.", locate(), getLookaheadName()));
+    }
+
+    /**
+     * @brief The error where the terminal {expected} does not match the lookahead.
+     */
+    SyntaxError mismatch(std::string_view expected) const
+    {
+        return SyntaxError(
+            std::format("{}The terminal symbol {} does not match the top of the input stack {}.",
+                        locate(), expected, getLookaheadName()));
+    }
+
+private:
+    TokenSource& m_tokens;
+    CompilationUnit* m_unit;
+    Token m_token;
+    TokenKind m_kind = TokenKind::Nul;  // The kind of the lookahead, as the grammar takes it.
+    bool m_atEnd = false;               // Whether the source is exhausted.
+    std::vector<Frame> m_frames;        // The pending operators, from the whole input up.
+    NodeId m_lastBegin = 0;             // The first node of the subtree of the last operand.
+    int m_value = 0;                    // The value of the last operand.
+};
+
+void PrattParser::parse(TokenSource& tokens) const
+{
+    analyze(tokens, nullptr);
+}
+
+void PrattParser::parse(TokenSource& tokens, CompilationUnit& unit) const
+{
+    unit.reset(tokens.getSource());
+    if (!analyze(tokens, &unit)) {
+        unit.reset(tokens.getSource());
+    }
+}
+
+bool PrattParser::analyze(TokenSource& tokens, CompilationUnit* unit) const
+{
+    return m_mode == Mode::Semantics ? analyze<true>(tokens, unit) : analyze<false>(tokens, unit);
+}
+
+template <bool SEMANTICS>
+bool PrattParser::analyze(TokenSource& tokens, CompilationUnit* unit) const
+{
+    try {
+        Context<SEMANTICS> context(tokens, unit);
+        NodeId root = context.expression();
+        if (unit) {
+            unit->setRoot(root);
+        }
+    } catch (const SyntaxError& e) {
+        Reporter::error(e.what());
+        return false;
+    } catch (const SemanticError& e) {
+        Reporter::error(e.what());
+        return false;
+    }
+    Reporter::success(SEMANTICS ? "Syntax and semantics correct." : "Syntax correct.");
+    return true;
+}
+}  // namespace PL0
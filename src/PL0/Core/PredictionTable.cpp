@@ -0,0 +1,180 @@
+#include "PL0/Core/PredictionTable.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace PL0
+{
+struct PredictionTable::Storage
+{
+    std::vector<Symbol> names;
+    std::vector<std::string_view> nameViews;        // Views of the names, which never move.
+    std::map<Symbol, SymbolId, std::less<>> ids;  // The ID of each symbol.
+    std::vector<uint32_t> cells;
+    std::vector<uint32_t> rhsOffsets;
+    std::vector<SymbolId> rhsPool;
+};
+
+PredictionTable::PredictionTable(const RuleAnalyzer& analyzer,
+                                 const std::vector<std::vector<Symbol>>& rhsList)
+{
+    auto storage = std::make_shared<Storage>();
+    std::vector<Symbol>& names = storage->names;
+    std::map<Symbol, SymbolId, std::less<>>& ids = storage->ids;
+
+    const std::vector<Rule>& rules = analyzer.getRules();
+    auto getRhs = [&](size_t i) -> const std::vector<Symbol>& {
+        return rhsList.empty() ? rules[i].rhs : rhsList[i];
+    };
+    auto addSymbol = [&](const Symbol& symbol) {
+        if (ids.emplace(symbol, static_cast<SymbolId>(names.size())).second) {
+            names.push_back(symbol);
+        }
+    };
+
+    // 1) Number the symbols: terminals, ENDSYM, non-terminals, and then the rest.
+    for (const Symbol& symbol : analyzer.getTerminals()) {
+        addSymbol(symbol);
+    }
+    addSymbol(ENDSYM);
+    m_terminalCount = static_cast<uint32_t>(names.size());
+    for (const Symbol& symbol : analyzer.getNonTerminals()) {
+        addSymbol(symbol);
+    }
+    m_nonTerminalCount = static_cast<uint32_t>(names.size()) - m_terminalCount;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        for (const Symbol& symbol : getRhs(i)) {
+            if (symbol != EPSILON) {
+                addSymbol(symbol);
+            }
+        }
+    }
+    auto beginSym = ids.find(analyzer.getBeginSym());
+    m_beginSym = beginSym != ids.end() ? beginSym->second : NO_SYMBOL;
+
+    // 2) Pool the right-hand sides.
+    storage->rhsOffsets.reserve(rules.size() + 1);
+    storage->rhsOffsets.push_back(0);
+    for (size_t i = 0; i < rules.size(); ++i) {
+        for (const Symbol& symbol : getRhs(i)) {
+            if (symbol != EPSILON) {
+                storage->rhsPool.push_back(ids.find(symbol)->second);
+            }
+        }
+        storage->rhsOffsets.push_back(static_cast<uint32_t>(storage->rhsPool.size()));
+    }
+
+    // 3) Fill the cells by the SELECT sets.
+    storage->cells.assign(size_t(m_nonTerminalCount) * m_terminalCount, NO_RULE);
+    for (size_t i = 0; i < rules.size(); ++i) {
+        SymbolId lhs = ids.find(rules[i].lhs)->second;
+        for (const Symbol& symbol : analyzer.getSelectSet(i)) {
+            SymbolId terminal = ids.find(symbol)->second;
+            storage->cells[(lhs - m_terminalCount) * m_terminalCount + terminal] =
+                static_cast<uint32_t>(i);
+        }
+    }
+    adopt(std::move(storage));
+}
+
+PredictionTable::PredictionTable(std::vector<Symbol> names, uint32_t terminalCount,
+                                 uint32_t nonTerminalCount, SymbolId beginSym,
+                                 std::vector<uint32_t> cells, std::vector<uint32_t> rhsOffsets,
+                                 std::vector<SymbolId> rhsPool)
+    : m_terminalCount(terminalCount), m_nonTerminalCount(nonTerminalCount), m_beginSym(beginSym)
+{
+    auto check = [](bool valid) {
+        if (!valid) {
+            throw std::runtime_error("Invalid prediction table");
+        }
+    };
+
+    auto storage = std::make_shared<Storage>();
+    storage->names = std::move(names);
+    storage->cells = std::move(cells);
+    storage->rhsOffsets = std::move(rhsOffsets);
+    storage->rhsPool = std::move(rhsPool);
+    for (size_t i = 0; i < storage->names.size(); ++i) {
+        check(storage->ids.emplace(storage->names[i], static_cast<SymbolId>(i)).second);
+    }
+    adopt(std::move(storage));
+
+    check(m_terminalCount > 0 && size_t(m_terminalCount) + m_nonTerminalCount <= m_names.size());
+    check(m_names[getEndSym()] == ENDSYM && isNonTerminal(m_beginSym));
+
+    check(!m_rhsOffsets.empty() && m_rhsOffsets.front() == 0 &&
+          m_rhsOffsets.back() == m_rhsPool.size() && std::ranges::is_sorted(m_rhsOffsets));
+    check(std::ranges::all_of(m_rhsPool, [this](SymbolId id) { return id < m_names.size(); }));
+
+    size_t ruleCount = getRuleCount();
+    check(m_cells.size() == size_t(m_nonTerminalCount) * m_terminalCount);
+    check(std::ranges::all_of(
+        m_cells, [ruleCount](uint32_t rule) { return rule == NO_RULE || rule < ruleCount; }));
+}
+
+PredictionTable PredictionTable::view(std::span<const std::string_view> names,
+                                      uint32_t terminalCount, uint32_t nonTerminalCount,
+                                      SymbolId beginSym, std::span<const uint32_t> cells,
+                                      std::span<const uint32_t> rhsOffsets,
+                                      std::span<const SymbolId> rhsPool)
+{
+    PredictionTable table;
+    table.m_names = names;
+    table.m_terminalCount = terminalCount;
+    table.m_nonTerminalCount = nonTerminalCount;
+    table.m_beginSym = beginSym;
+    table.m_cells = cells;
+    table.m_rhsOffsets = rhsOffsets;
+    table.m_rhsPool = rhsPool;
+    return table;
+}
+
+void PredictionTable::adopt(std::shared_ptr<Storage> storage)
+{
+    storage->nameViews.assign(storage->names.begin(), storage->names.end());
+    m_names = storage->nameViews;
+    m_cells = storage->cells;
+    m_rhsOffsets = storage->rhsOffsets;
+    m_rhsPool = storage->rhsPool;
+    m_storage = std::move(storage);
+}
+
+SymbolId PredictionTable::findSymbol(std::string_view symbol) const
+{
+    if (m_storage) {
+        auto it = m_storage->ids.find(symbol);
+        return it != m_storage->ids.end() ? it->second : NO_SYMBOL;
+    }
+
+    // The tables of the built-in grammars are small, and a symbol is rarely looked up by name.
+    auto it = std::ranges::find(m_names, symbol);
+    return it != m_names.end() ? static_cast<SymbolId>(it - m_names.begin()) : NO_SYMBOL;
+}
+
+void PredictionTable::print() const
+{
+    for (SymbolId lhs = m_terminalCount; lhs < m_terminalCount + m_nonTerminalCount; ++lhs) {
+        std::cout << m_names[lhs] << " -- ";
+        for (SymbolId terminal = 0; terminal < m_terminalCount; ++terminal) {
+            uint32_t rule = predict(lhs, terminal);
+            if (rule == NO_RULE) {
+                continue;
+            }
+            std::cout << m_names[terminal] << " -> ";
+            std::span<const SymbolId> rhs = getRhs(rule);
+            if (rhs.empty()) {
+                std::cout << "ε";
+            }
+            for (SymbolId symbol : rhs) {
+                if (isTerminal(symbol) || isNonTerminal(symbol)) {
+                    std::cout << m_names[symbol];
+                } else {
+                    std::cout << "{" << m_names[symbol] << "}";
+                }
+            }
+            std::cout << ", ";
+        }
+        std::cout << "\n";
+    }
+}
+}  // namespace PL0
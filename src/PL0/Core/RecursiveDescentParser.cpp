@@ -0,0 +1,380 @@
+#include "PL0/Core/RecursiveDescentParser.hpp"
+#include "PL0/Core/Symbol.hpp"
+#include "PL0/Utils/Error.hpp"
+#include "PL0/Utils/Reporter.hpp"
+#include <format>
+
+namespace PL0
+{
+/**
+ * @brief The state of one parse: the token source, the lookahead token and the nesting depth.
+ * @note Each function parses one non-terminal of the grammar, and returns with the lookahead on
+ *      the first token after it.
+ */
+class RecursiveDescentParser::Context
+{
+public:
+    /**
+     * @param unit The compilation unit to build the tree in, or nullptr to build no tree.
+     */
+    Context(TokenSource& tokens, CompilationUnit* unit) : m_tokens(tokens), m_unit(unit)
+    {
+        advance();
+    }
+
+    NodeId program()
+    {
+        uint32_t offset = m_token.offset;
+        NodeId begin = mark();
+        block();
+        match(TokenKind::Period);
+        if (!m_atEnd) {
+            throw error(ENDSYM);
+        }
+        return node(NodeKind::Program, offset, begin);
+    }
+
+private:
+    /**
+     * @brief Count a level of nesting for as long as it is alive.
+     */
+    class Nest
+    {
+    public:
+        explicit Nest(Context& context) : m_context(context)
+        {
+            if (++m_context.m_depth > MAX_DEPTH) {
+                throw SyntaxError(m_context.locate() + "The input is nested too deeply.");
+            }
+        }
+        ~Nest()
+        {
+            --m_context.m_depth;
+        }
+        Nest(const Nest&) = delete;
+        Nest& operator=(const Nest&) = delete;
+
+    private:
+        Context& m_context;
+    };
+
+    NodeId block()
+    {
+        uint32_t offset = m_token.offset;
+        NodeId begin = mark();
+        if (accept(TokenKind::Const)) {
+            do {
+                uint32_t constOffset = m_token.offset;
+                NodeId constBegin = ident();
+                match(TokenKind::Eql);
+                leaf(NodeKind::Number, static_cast<uint32_t>(m_token.number));
+                match(TokenKind::Number);
+                node(NodeKind::Const, constOffset, constBegin);
+            } while (accept(TokenKind::Comma));
+            match(TokenKind::Semicolon);
+        }
+        if (accept(TokenKind::Var)) {
+            do {
+                leaf(NodeKind::Var, m_token.id);
+                match(TokenKind::Ident);
+            } while (accept(TokenKind::Comma));
+            match(TokenKind::Semicolon);
+        }
+        while (m_kind == TokenKind::Procedure) {
+            uint32_t procedureOffset = m_token.offset;
+            advance();
+            NodeId procedureBegin = ident();
+            match(TokenKind::Semicolon);
+            {
+                Nest nest(*this);
+                block();
+            }
+            match(TokenKind::Semicolon);
+            node(NodeKind::Procedure, procedureOffset, procedureBegin);
+        }
+        statement();
+        return node(NodeKind::Block, offset, begin);
+    }
+
+    NodeId statement()
+    {
+        uint32_t offset = m_token.offset;
+        NodeId begin = mark();
+        NodeKind kind;
+        switch (m_kind) {
+        case TokenKind::Ident:
+            kind = NodeKind::Assign;
+            ident();
+            match(TokenKind::Becomes);
+            expression();
+            break;
+        case TokenKind::Call:
+            kind = NodeKind::Call;
+            advance();
+            ident();
+            break;
+        case TokenKind::Begin: {
+            Nest nest(*this);
+            kind = NodeKind::Begin;
+            advance();
+            statement();
+            while (accept(TokenKind::Semicolon)) {
+                statement();
+            }
+            if (!accept(TokenKind::End)) {
+                throw error("; or end");
+            }
+            break;
+        }
+        case TokenKind::If:
+        case TokenKind::While: {
+            Nest nest(*this);
+            bool isIf = m_kind == TokenKind::If;
+            kind = isIf ? NodeKind::If : NodeKind::While;
+            advance();
+            condition();
+            match(isIf ? TokenKind::Then : TokenKind::Do);
+            statement();
+            break;
+        }
+        case TokenKind::Read:
+            kind = NodeKind::Read;
+            advance();
+            match(TokenKind::LParen);
+            do {
+                ident();
+            } while (accept(TokenKind::Comma));
+            match(TokenKind::RParen);
+            break;
+        case TokenKind::Write:
+            kind = NodeKind::Write;
+            advance();
+            match(TokenKind::LParen);
+            do {
+                expression();
+            } while (accept(TokenKind::Comma));
+            match(TokenKind::RParen);
+            break;
+        default:  // The empty statement
+            return leaf(NodeKind::Empty, 0);
+        }
+        return node(kind, offset, begin);
+    }
+
+    NodeId condition()
+    {
+        uint32_t offset = m_token.offset;
+        NodeId begin = mark();
+        if (accept(TokenKind::Odd)) {
+            expression();
+            return node(NodeKind::Odd, offset, begin);
+        }
+        expression();
+        NodeKind kind;
+        switch (m_kind) {
+        case TokenKind::Eql:
+            kind = NodeKind::Eql;
+            break;
+        case TokenKind::Neq:
+            kind = NodeKind::Neq;
+            break;
+        case TokenKind::Lss:
+            kind = NodeKind::Lss;
+            break;
+        case TokenKind::Leq:
+            kind = NodeKind::Leq;
+            break;
+        case TokenKind::Gtr:
+            kind = NodeKind::Gtr;
+            break;
+        case TokenKind::Geq:
+            kind = NodeKind::Geq;
+            break;
+        default:
+            throw error("A relational operator");
+        }
+        offset = m_token.offset;
+        advance();
+        expression();
+        return node(kind, offset, begin);
+    }
+
+    NodeId expression()
+    {
+        uint32_t offset = m_token.offset;
+        NodeId begin = mark();
+        bool negative = m_kind == TokenKind::Minus;
+        if (negative || m_kind == TokenKind::Plus) {
+            advance();
+        }
+        NodeId root = term();
+        if (negative) {
+            root = node(NodeKind::Neg, offset, begin);
+        }
+        while (m_kind == TokenKind::Plus || m_kind == TokenKind::Minus) {
+            NodeKind kind = m_kind == TokenKind::Plus ? NodeKind::Add : NodeKind::Sub;
+            offset = m_token.offset;
+            advance();
+            term();
+            root = node(kind, offset, begin);
+        }
+        return root;
+    }
+
+    NodeId term()
+    {
+        NodeId begin = mark();
+        NodeId root = factor();
+        while (m_kind == TokenKind::Times || m_kind == TokenKind::Slash) {
+            NodeKind kind = m_kind == TokenKind::Times ? NodeKind::Mul : NodeKind::Div;
+            uint32_t offset = m_token.offset;
+            advance();
+            factor();
+            root = node(kind, offset, begin);
+        }
+        return root;
+    }
+
+    NodeId factor()
+    {
+        switch (m_kind) {
+        case TokenKind::Ident:
+            return ident();
+        case TokenKind::Number: {
+            NodeId number = leaf(NodeKind::Number, static_cast<uint32_t>(m_token.number));
+            advance();
+            return number;
+        }
+        case TokenKind::LParen: {
+            Nest nest(*this);
+            advance();
+            NodeId inner = expression();
+            match(TokenKind::RParen);
+            return inner;
+        }
+        default:
+            throw error("id, num or (");
+        }
+    }
+
+    /**
+     * @brief Match an identifier, and build its leaf.
+     */
+    NodeId ident()
+    {
+        NodeId id = leaf(NodeKind::Ident, m_token.id);
+        match(TokenKind::Ident);
+        return id;
+    }
+
+private:
+    /**
+     * @note The nodes are only built if there is a unit, so parsing without a tree costs a branch
+     *      per node. Each function marks where its subtree begins before parsing its children, and
+     *      adds its node after them, so the nodes are in post-order (see CompilationUnit).
+     */
+    NodeId mark() const
+    {
+        return m_unit ? m_unit->getNodeCount() : NO_NODE;
+    }
+
+    NodeId leaf(NodeKind kind, uint32_t value)
+    {
+        return m_unit ? m_unit->addLeaf(kind, m_token.offset, value) : NO_NODE;
+    }
+
+    NodeId node(NodeKind kind, uint32_t offset, NodeId begin)
+    {
+        return m_unit ? m_unit->addNode(kind, offset, begin) : NO_NODE;
+    }
+
+private:
+    /**
+     * @brief Move the lookahead to the next token. Once the source is exhausted, the kind of the
+     *      lookahead is TokenKind::Nul, which the grammar never accepts.
+     */
+    void advance()
+    {
+        if (m_tokens.next(m_token)) {
+            m_kind = m_token.kind;
+        } else {
+            m_kind = TokenKind::Nul;
+            m_atEnd = true;
+        }
+    }
+
+    /**
+     * @return Whether the lookahead is of the kind, in which case it is consumed.
+     */
+    bool accept(TokenKind kind)
+    {
+        if (m_kind != kind) {
+            return false;
+        }
+        advance();
+        return true;
+    }
+
+    /**
+     * @brief Consume the lookahead, which must be of the kind.
+     */
+    void match(TokenKind kind)
+    {
+        if (!accept(kind)) {
+            throw error(TOKEN_KIND_SYMBOLS[static_cast<size_t>(kind)]);
+        }
+    }
+
+    std::string locate() const
+    {
+        return Parser::locate(m_tokens, m_atEnd ? NO_OFFSET : m_token.offset);
+    }
+
+    /**
+     * @param expected What is expected instead of the lookahead.
+     */
+    SyntaxError error(std::string_view expected) const
+    {
+        std::string_view found = m_atEnd ? std::string_view(ENDSYM) : translate2Symbol(m_token);
+        return SyntaxError(
+            std::format("{}{} is expected, but {} is found.", locate(), expected, found));
+    }
+
+private:
+    TokenSource& m_tokens;
+    CompilationUnit* m_unit;
+    Token m_token;
+    TokenKind m_kind = TokenKind::Nul;  // The kind of the lookahead.
+    bool m_atEnd = false;               // Whether the source is exhausted.
+    size_t m_depth = 0;
+};
+
+void RecursiveDescentParser::parse(TokenSource& tokens) const
+{
+    analyze(tokens, nullptr);
+}
+
+void RecursiveDescentParser::parse(TokenSource& tokens, CompilationUnit& unit) const
+{
+    unit.reset(tokens.getSource());
+    if (!analyze(tokens, &unit)) {
+        unit.reset(tokens.getSource());
+    }
+}
+
+bool RecursiveDescentParser::analyze(TokenSource& tokens, CompilationUnit* unit) const
+{
+    try {
+        Context context(tokens, unit);
+        NodeId root = context.program();
+        if (unit) {
+            unit->setRoot(root);
+        }
+    } catch (const SyntaxError& e) {
+        Reporter::error(e.what());
+        return false;
+    }
+    Reporter::success("Syntax correct.");
+    return true;
+}
+}  // namespace PL0
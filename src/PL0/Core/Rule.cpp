@@ -1,10 +1,172 @@
 #include "PL0/Core/Rule.hpp"
+#include <bit>
+#include <deque>
 #include <format>
 #include <iostream>
+#include <limits>
 #include <ranges>
 
 namespace PL0
 {
+namespace
+{
+/**
+ * @brief A table of fixed-width bitsets, one per row, stored in one array of words.
+ */
+class BitsetTable
+{
+public:
+    BitsetTable(size_t rows, size_t bits) : m_words((bits + 63) / 64), m_data(rows * m_words, 0)
+    {
+    }
+
+    inline uint64_t* operator[](size_t row)
+    {
+        return m_data.data() + row * m_words;
+    }
+
+    inline const uint64_t* operator[](size_t row) const
+    {
+        return m_data.data() + row * m_words;
+    }
+
+    inline size_t getWords() const
+    {
+        return m_words;
+    }
+
+    static inline void set(uint64_t* bits, size_t index)
+    {
+        bits[index / 64] |= uint64_t(1) << (index % 64);
+    }
+
+    static inline void reset(uint64_t* bits, size_t index)
+    {
+        bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+
+    static inline bool test(const uint64_t* bits, size_t index)
+    {
+        return (bits[index / 64] >> (index % 64)) & 1;
+    }
+
+    /**
+     * @brief {dst} |= {src} & ~{mask}, word by word.
+     * @return Whether {dst} has changed.
+     */
+    inline bool merge(uint64_t* dst, const uint64_t* src, const uint64_t* mask = nullptr) const
+    {
+        uint64_t changed = 0;
+        for (size_t i = 0; i < m_words; ++i) {
+            uint64_t word = dst[i] | (mask ? src[i] & ~mask[i] : src[i]);
+            changed |= word ^ dst[i];
+            dst[i] = word;
+        }
+        return changed != 0;
+    }
+
+private:
+    size_t m_words;
+    std::vector<uint64_t> m_data;
+};
+
+/**
+ * @brief Solve a system of monotone set equations over the nodes [0, inputs.size()).
+ * @param inputs The nodes whose sets the set of each node is calculated from.
+ * @param update Recalculate the set of a node from the sets of its inputs, and return whether it
+ *      has grown.
+ * @note The nodes are split into the strongly connected components of the dependency graph, which
+ *      are solved in topological order, so a component is solved after the sets of all its inputs
+ *      are final. Within a component, a worklist revisits only the nodes one of whose inputs has
+ *      grown. So a chain of n dependencies takes n updates, instead of n sweeps over all nodes.
+ */
+template <typename Update>
+void solveFixpoint(const std::vector<std::vector<uint32_t>>& inputs, Update update)
+{
+    constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    const size_t count = inputs.size();
+    std::vector<std::vector<uint32_t>> users(count);
+    for (uint32_t v = 0; v < count; ++v) {
+        for (uint32_t u : inputs[v]) {
+            users[u].push_back(v);
+        }
+    }
+
+    /**
+     * @note Tarjan's algorithm, without recursion. A component is completed only after all the
+     *      components it can reach, i.e. its inputs, so the components are solved as they are
+     *      completed.
+     */
+    std::vector<uint32_t> index(count, NONE);
+    std::vector<uint32_t> lowLink(count);
+    std::vector<uint32_t> component(count, NONE);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, size_t>> path;  // <node, next input to visit>
+    std::deque<uint32_t> worklist;
+    std::vector<bool> queued(count, false);
+    uint32_t nextIndex = 0;
+    uint32_t componentCount = 0;
+
+    for (uint32_t root = 0; root < count; ++root) {
+        if (index[root] != NONE) {
+            continue;
+        }
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        path.emplace_back(root, 0);
+        while (!path.empty()) {
+            auto& [v, next] = path.back();
+            if (next < inputs[v].size()) {
+                uint32_t u = inputs[v][next++];
+                if (index[u] == NONE) {
+                    index[u] = lowLink[u] = nextIndex++;
+                    stack.push_back(u);
+                    path.emplace_back(u, 0);
+                } else if (component[u] == NONE) {
+                    lowLink[v] = std::min(lowLink[v], index[u]);
+                }
+                continue;
+            }
+
+            uint32_t node = v;
+            path.pop_back();
+            if (!path.empty()) {
+                uint32_t parent = path.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+            if (lowLink[node] != index[node]) {
+                continue;
+            }
+
+            // {node} is the root of a component: pop and solve it.
+            uint32_t w;
+            do {
+                w = stack.back();
+                stack.pop_back();
+                component[w] = componentCount;
+                worklist.push_back(w);
+                queued[w] = true;
+            } while (w != node);
+            while (!worklist.empty()) {
+                uint32_t x = worklist.front();
+                worklist.pop_front();
+                queued[x] = false;
+                if (!update(x)) {
+                    continue;
+                }
+                for (uint32_t y : users[x]) {
+                    if (component[y] == componentCount && !queued[y]) {
+                        worklist.push_back(y);
+                        queued[y] = true;
+                    }
+                }
+            }
+            ++componentCount;
+        }
+    }
+}
+}  // namespace
+
 void RuleAnalyzer::addRule(const Symbol& lhs, const std::vector<Symbol>& rhs)
 {
     // Add the rule to m_rules.
@@ -65,37 +227,43 @@ void RuleAnalyzer::calcFirstSets()
      *          2. Calculate the FIRST set of the right-hand side symbols of these rules.
      *          3. Union these FIRST sets.
      *     However, the FIRST sets of some right-hand side symbols may have not been calculated.
-     *     We need to keep iterating until no more symbols can be added to the FIRST set.
+     *     So FIRST(X) depends on the FIRST sets of the non-terminals in the right-hand sides of X,
+     *     and is recalculated until none of them grows (see solveFixpoint).
      */
-
-    bool updated;
-    do {
-        updated = false;
-        m_firstSetCache.clear();  // Discard the cache
-
-        for (const auto& rule : m_rules) {
-            // Calculate the FIRST set of the right-hand side symbols of the rule.
-            auto [firstSet, allHasEpsilon] = calcFirstSetOfSyms(rule.rhs, 0, rule.rhs.size());
-
-            // Union the FIRST sets.
-            for (const Symbol& sym : firstSet) {
-                auto [_, inserted] = m_firstSet[rule.lhs].insert(sym);
-                if (inserted) {
-                    updated = true;
-                }
+    std::vector<const Symbol*> nonTerminals;
+    std::map<Symbol, uint32_t, std::less<>> ids;
+    for (const Symbol& sym : m_nonTerminals) {
+        ids.emplace(sym, static_cast<uint32_t>(nonTerminals.size()));
+        nonTerminals.push_back(&sym);
+    }
+    std::vector<std::vector<const Rule*>> rulesOf(nonTerminals.size());
+    std::vector<std::vector<uint32_t>> inputs(nonTerminals.size());
+    for (const auto& rule : m_rules) {
+        uint32_t lhs = ids.at(rule.lhs);
+        rulesOf[lhs].push_back(&rule);
+        for (const Symbol& sym : rule.rhs) {
+            if (auto it = ids.find(sym); it != ids.end()) {
+                inputs[lhs].push_back(it->second);
             }
+        }
+    }
 
-            /**
-             * @note Cache the FIRST set of each rule.
-             *      If no FIRST set has been updated, the cache is valid.
-             *      Otherwise, discard the cache and recalculate the FIRST set in the next
-             *      iteration.
-             */
-            if (!updated) {
-                m_firstSetCache.push_back({firstSet, allHasEpsilon});
-            }
+    solveFixpoint(inputs, [&](uint32_t lhs) {
+        std::set<Symbol>& lhsFirst = m_firstSet[*nonTerminals[lhs]];
+        size_t size = lhsFirst.size();
+        for (const Rule* rule : rulesOf[lhs]) {
+            auto [firstSet, _] = calcFirstSetOfSyms(rule->rhs, 0, rule->rhs.size());
+            lhsFirst.insert(firstSet.begin(), firstSet.end());
         }
-    } while (updated);
+        return lhsFirst.size() != size;
+    });
+
+    // Cache the FIRST set of each rule, now that the FIRST sets are final.
+    m_firstSetCache.clear();
+    m_firstSetCache.reserve(m_rules.size());
+    for (const auto& rule : m_rules) {
+        m_firstSetCache.push_back(calcFirstSetOfSyms(rule.rhs, 0, rule.rhs.size()));
+    }
 }
 
 void RuleAnalyzer::calcFollowSets()
@@ -113,53 +281,65 @@ void RuleAnalyzer::calcFollowSets()
      *          3. Calculate the FIRST set of the symbols after X in the right-hand side.
      *          4. Add the non-ε symbols in the FIRST set to the FOLLOW set of X.
      *          5. If the FIRST set contains ε, add the FOLLOW set of the left-hand side symbol.
-     *     However, the FOLLOW sets of some symbols may have not been calculated.
-     *     We need to keep iterating until no more symbols can be added to the FOLLOW set.
+     *     Steps 1 to 4 only depend on the FIRST sets, so they are done once. Step 5 makes FOLLOW(X)
+     *     depend on the FOLLOW sets of some left-hand side symbols, and is repeated until none of
+     *     them grows (see solveFixpoint).
      */
 
     // Add # to the FOLLOW set of the begin symbol.
     m_followSet[m_beginSym].insert(ENDSYM);
 
-    bool updated;
-    do {
-        updated = false;
-        for (const auto& rule : m_rules) {
-            const auto& lhs = rule.lhs;
-            const auto& rhs = rule.rhs;
-
-            for (size_t i = 0; i < rhs.size(); ++i) {
-                const Symbol& rhsSym = rhs[i];  // X
-
-                if (isNonTerminal(rhsSym)) {
-                    // Calculate the FIRST set of the symbols after X in the right-hand side.
-                    auto [firstSet, allHasEpsilon] = calcFirstSetOfSyms(rhs, i + 1, rhs.size());
-                    for (const Symbol& sym : firstSet) {
-                        // Add the non-ε symbols in the FIRST set to the FOLLOW set of X.
-                        if (sym != EPSILON) {
-                            auto [_, inserted] = m_followSet[rhsSym].insert(sym);
-                            if (inserted) {
-                                updated = true;
-                            }
-                        }
-                    }
+    std::vector<std::set<Symbol>*> followSets;
+    std::map<Symbol, uint32_t, std::less<>> ids;
+    for (const Symbol& sym : m_nonTerminals) {
+        ids.emplace(sym, static_cast<uint32_t>(followSets.size()));
+        followSets.push_back(&m_followSet[sym]);
+    }
+    std::vector<std::vector<uint32_t>> inputs(followSets.size());
+    for (const auto& rule : m_rules) {
+        const auto& lhs = rule.lhs;
+        const auto& rhs = rule.rhs;
+
+        for (size_t i = 0; i < rhs.size(); ++i) {
+            auto rhsSym = ids.find(rhs[i]);  // X
+            if (rhsSym == ids.end()) {
+                continue;
+            }
 
-                    // If the FIRST set contains ε, add the FOLLOW set of the left-hand side symbol.
-                    if (allHasEpsilon) {
-                        for (const Symbol& sym : m_followSet[lhs]) {
-                            auto [_, inserted] = m_followSet[rhsSym].insert(sym);
-                            if (inserted) {
-                                updated = true;
-                            }
-                        }
-                    }
+            // Calculate the FIRST set of the symbols after X in the right-hand side.
+            auto [firstSet, allHasEpsilon] = calcFirstSetOfSyms(rhs, i + 1, rhs.size());
+            for (const Symbol& sym : firstSet) {
+                // Add the non-ε symbols in the FIRST set to the FOLLOW set of X.
+                if (sym != EPSILON) {
+                    followSets[rhsSym->second]->insert(sym);
                 }
             }
+
+            // If the FIRST set contains ε, FOLLOW(X) depends on the FOLLOW set of the left-hand
+            // side symbol.
+            if (allHasEpsilon && lhs != rhsSym->first) {
+                inputs[rhsSym->second].push_back(ids.at(lhs));
+            }
+        }
+    }
+
+    solveFixpoint(inputs, [&](uint32_t sym) {
+        std::set<Symbol>& symFollow = *followSets[sym];
+        size_t size = symFollow.size();
+        for (uint32_t lhs : inputs[sym]) {
+            symFollow.insert(followSets[lhs]->begin(), followSets[lhs]->end());
         }
-    } while (updated);
+        return symFollow.size() != size;
+    });
 }
 
 void RuleAnalyzer::calcSelectSets()
 {
+    if (m_mode == Mode::Bitsets) {
+        calcSelectSetsWithBitsets();
+        return;
+    }
+
     calcFirstSets();
     calcFollowSets();
 
@@ -190,6 +370,156 @@ void RuleAnalyzer::calcSelectSets()
     m_firstSetCache.clear();
 }
 
+void RuleAnalyzer::calcSelectSetsWithBitsets()
+{
+    /**
+     * @note The terminals are numbered in the order of m_terminals, followed by ENDSYM and ε,
+     *      which are the bits of each set. The non-terminals are numbered in the order of
+     *      m_nonTerminals, which are the rows of the FIRST and FOLLOW tables.
+     *      A symbol of a right-hand side is encoded as its ID, with NON_TERMINAL set for a
+     *      non-terminal.
+     */
+    constexpr uint32_t NON_TERMINAL = uint32_t(1) << 31;
+    std::vector<Symbol> terminals(m_terminals.begin(), m_terminals.end());
+    terminals.push_back(ENDSYM);
+    const size_t endSym = terminals.size() - 1;
+    const size_t epsilon = terminals.size();
+    std::vector<Symbol> nonTerminals(m_nonTerminals.begin(), m_nonTerminals.end());
+
+    std::map<Symbol, uint32_t, std::less<>> ids;
+    for (size_t i = 0; i < terminals.size(); ++i) {
+        ids.emplace(terminals[i], static_cast<uint32_t>(i));
+    }
+    for (size_t i = 0; i < nonTerminals.size(); ++i) {
+        ids.emplace(nonTerminals[i], static_cast<uint32_t>(i) | NON_TERMINAL);
+    }
+
+    std::vector<uint32_t> lhsIds(m_rules.size());
+    std::vector<std::vector<uint32_t>> rhsIds(m_rules.size());
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        lhsIds[i] = ids.at(m_rules[i].lhs) & ~NON_TERMINAL;
+        for (const Symbol& sym : m_rules[i].rhs) {
+            if (sym != EPSILON) {  // ε is an empty right-hand side.
+                rhsIds[i].push_back(ids.at(sym));
+            }
+        }
+    }
+
+    BitsetTable first(nonTerminals.size(), epsilon + 1);
+    BitsetTable follow(nonTerminals.size(), epsilon + 1);
+    std::vector<uint64_t> epsilonMask(first.getWords(), 0);
+    BitsetTable::set(epsilonMask.data(), epsilon);
+
+    /**
+     * @brief Calculate the FIRST set of rhs[begin, end) into {bits}, which must be empty.
+     * @return Whether every symbol of the sequence derives ε, in which case ε is in {bits}.
+     */
+    auto calcFirstOfSyms = [&](const std::vector<uint32_t>& rhs, size_t begin, uint64_t* bits) {
+        for (size_t i = begin; i < rhs.size(); ++i) {
+            if (!(rhs[i] & NON_TERMINAL)) {
+                BitsetTable::set(bits, rhs[i]);
+                return false;
+            }
+            const uint64_t* symFirst = first[rhs[i] & ~NON_TERMINAL];
+            first.merge(bits, symFirst, epsilonMask.data());
+            if (!BitsetTable::test(symFirst, epsilon)) {
+                return false;
+            }
+        }
+        BitsetTable::set(bits, epsilon);
+        return true;
+    };
+
+    // FIRST sets: the same dependencies as calcFirstSets(), with word-wide unions.
+    std::vector<std::vector<uint32_t>> rulesOf(nonTerminals.size());
+    std::vector<std::vector<uint32_t>> inputs(nonTerminals.size());
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        rulesOf[lhsIds[i]].push_back(static_cast<uint32_t>(i));
+        for (uint32_t sym : rhsIds[i]) {
+            if (sym & NON_TERMINAL) {
+                inputs[lhsIds[i]].push_back(sym & ~NON_TERMINAL);
+            }
+        }
+    }
+    std::vector<uint64_t> bits(first.getWords());
+    solveFixpoint(inputs, [&](uint32_t lhs) {
+        bool updated = false;
+        for (uint32_t rule : rulesOf[lhs]) {
+            std::ranges::fill(bits, 0);
+            calcFirstOfSyms(rhsIds[rule], 0, bits.data());
+            updated |= first.merge(first[lhs], bits.data());
+        }
+        return updated;
+    });
+
+    // FOLLOW sets: the same dependencies as calcFollowSets().
+    auto beginSym = ids.find(m_beginSym);
+    if (beginSym != ids.end() && (beginSym->second & NON_TERMINAL)) {
+        BitsetTable::set(follow[beginSym->second & ~NON_TERMINAL], endSym);
+    }
+    for (std::vector<uint32_t>& symInputs : inputs) {
+        symInputs.clear();
+    }
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        const std::vector<uint32_t>& rhs = rhsIds[i];
+        for (size_t j = 0; j < rhs.size(); ++j) {
+            if (!(rhs[j] & NON_TERMINAL)) {
+                continue;
+            }
+            uint32_t sym = rhs[j] & ~NON_TERMINAL;
+            std::ranges::fill(bits, 0);
+            bool allHasEpsilon = calcFirstOfSyms(rhs, j + 1, bits.data());
+            follow.merge(follow[sym], bits.data(), epsilonMask.data());
+            if (allHasEpsilon && lhsIds[i] != sym) {
+                inputs[sym].push_back(lhsIds[i]);
+            }
+        }
+    }
+    solveFixpoint(inputs, [&](uint32_t sym) {
+        bool updated = false;
+        for (uint32_t lhs : inputs[sym]) {
+            updated |= follow.merge(follow[sym], follow[lhs]);
+        }
+        return updated;
+    });
+
+    // SELECT sets: FIRST(rhs) - {ε}, plus FOLLOW(lhs) if rhs derives ε.
+    BitsetTable select(m_rules.size(), epsilon + 1);
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        if (calcFirstOfSyms(rhsIds[i], 0, select[i])) {
+            BitsetTable::reset(select[i], epsilon);
+            select.merge(select[i], follow[lhsIds[i]]);
+        }
+    }
+
+    // Store the sets as the Sets mode does.
+    auto toSet = [&](const uint64_t* row) {
+        std::set<Symbol> set;
+        for (size_t w = 0; w < first.getWords(); ++w) {
+            for (uint64_t word = row[w]; word != 0; word &= word - 1) {
+                size_t index = w * 64 + std::countr_zero(word);
+                set.insert(index == epsilon ? EPSILON : terminals[index]);
+            }
+        }
+        return set;
+    };
+
+    m_firstSet.clear();
+    m_followSet.clear();
+    for (const Symbol& sym : m_terminals) {
+        m_firstSet[sym] = {sym};
+    }
+    for (size_t i = 0; i < nonTerminals.size(); ++i) {
+        m_firstSet[nonTerminals[i]] = toSet(first[i]);
+        m_followSet[nonTerminals[i]] = toSet(follow[i]);
+    }
+    m_selectSet.clear();
+    m_selectSet.reserve(m_rules.size());
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        m_selectSet.push_back(toSet(select[i]));
+    }
+}
+
 std::pair<std::set<Symbol>, bool> RuleAnalyzer::calcFirstSetOfSyms(const std::vector<Symbol>& syms,
                                                                    size_t beginIdx,
                                                                    size_t endIdx) const
@@ -197,7 +527,7 @@ std::pair<std::set<Symbol>, bool> RuleAnalyzer::calcFirstSetOfSyms(const std::ve
     std::set<Symbol> firstSet;
 
     // If X -> ε, FIRST(X) = {ε}.
-    if (syms[beginIdx] == EPSILON) {
+    if (beginIdx < endIdx && syms[beginIdx] == EPSILON) {
         firstSet.insert(EPSILON);
         return {firstSet, true};
     }
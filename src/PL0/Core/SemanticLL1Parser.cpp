@@ -1,155 +1,223 @@
 #include "PL0/Core/SemanticLL1Parser.hpp"
+#include "PL0/Core/StaticTable.hpp"
 #include "PL0/Utils/Error.hpp"
 #include "PL0/Utils/Reporter.hpp"
+#include <algorithm>
 #include <format>
 
 namespace PL0
 {
-SemanticLL1Parser::SemanticLL1Parser()
+namespace
 {
-    initSyntax();
-}
-
-void SemanticLL1Parser::initSyntax()
+/**
+ * @note The syntax of arithmetic expressions:
+ *  S -> E {0}                  {0} : print(E.val)
+ *  E -> + E' {1}               {1} : E.syn = E'.syn
+ *  E -> - E' {2}               {2} : E.syn = -E'.syn
+ *  E -> E' {3}                 {3} : E.syn = E'.syn
+ *  E' -> T {4} E'' {5}         {4} : E''.inh = T.val
+ *                              {5} : E'.syn = E''.syn
+ *  E'' -> + T {6} E''1 {7}     {6} : E''1.inh = E''.inh + T.val
+ *                              {7} : E''.syn = E''1.syn
+ *  E'' -> - T {8} E''1 {9}     {8} : E''1.inh = E''.inh - T.val
+ *                              {9} : E''.syn = E''1.syn
+ *  E'' -> ε {10}               {10} : E''.syn = E''.inh
+ *  T -> F {11} T' {12}         {11} : T'.inh = F.val
+ *                              {12} : T.val = T'.syn
+ *  T' -> * F {13} T'1 {14}     {13} : T'1.inh = T'.inh * F.val
+ *                              {14} : T'.syn = T'1.syn
+ *  T' -> / F {15} T'1 {16}     {15} : if F.val == 0 then error
+ *                                     T'1.inh = T'.inh / F.val
+ *                              {16} : T'.syn = T'1.syn
+ *  T' -> ε {17}                {17} : T'.syn = T'.inh
+ *  F -> ( E {18} )             {18} : F.val = E.val
+ *  F -> id {19}                {19} : error
+ *  F -> num {20}               {20} : F.val = num.val
+ *
+ * {n} is the action symbol for semantic analysis.
+ */
+constexpr StaticRule SEMANTIC_EXPRESSION_RULES[] = {
+    {"S", "E {0}"},
+    {"E", "+ E' {1}"},
+    {"E", "- E' {2}"},
+    {"E", "E' {3}"},
+    {"E'", "T {4} E'' {5}"},
+    {"E''", "+ T {6} E'' {7}", 3},
+    {"E''", "- T {8} E'' {9}", 3},
+    {"E''", "ε {10}", 0},
+    {"T", "F {11} T' {12}"},
+    {"T'", "* F {13} T' {14}", 3},
+    {"T'", "/ F {15} T' {16}", 3},
+    {"T'", "ε {17}", 0},
+    {"F", "( E {18} )"},
+    {"F", "id {19}"},
+    {"F", "num {20}"},
+};
+
+/**
+ * @note The tables are generated at compile time, so the parser costs nothing to build.
+ */
+using SemanticExpressionTable = StaticTable<SEMANTIC_EXPRESSION_RULES>;
+
+constexpr std::pair<std::string_view, Action::Function> SEMANTIC_EXPRESSION_ACTIONS[] = {
+    {"0", Action::print},   {"1", Action::assign},  {"2", Action::opposite},
+    {"3", Action::assign},  {"4", Action::assign},  {"5", Action::assign},
+    {"6", Action::add},     {"7", Action::assign},  {"8", Action::sub},
+    {"9", Action::assign},  {"10", Action::assign}, {"11", Action::assign},
+    {"12", Action::assign}, {"13", Action::mul},    {"14", Action::assign},
+    {"15", Action::div},    {"16", Action::assign}, {"17", Action::assign},
+    {"18", Action::assign}, {"19", Action::assign}, {"20", Action::assign},
+};
+
+/**
+ * @brief The action function of each symbol ID of the built-in grammar.
+ */
+constexpr auto SEMANTIC_EXPRESSION_ACTION_FUNCS = [] {
+    std::array<Action::Function, SemanticExpressionTable::getSymbolCount()> funcs{};
+    for (const auto& [actionSym, func] : SEMANTIC_EXPRESSION_ACTIONS) {
+        funcs[SemanticExpressionTable::findSymbol(actionSym)] = func;
+    }
+    return funcs;
+}();
+
+// The symbols after the terminals and non-terminals are actions.
+static_assert(std::ranges::all_of(
+                  std::span(SEMANTIC_EXPRESSION_ACTION_FUNCS)
+                      .subspan(SemanticExpressionTable::getTerminalCount() +
+                               SemanticExpressionTable::getNonTerminalCount()),
+                  [](Action::Function func) { return func != nullptr; }),
+              "Every action of the built-in grammar must have a function.");
+
+constexpr std::array<SymbolId, TOKEN_KIND_COUNT> SEMANTIC_EXPRESSION_KIND_SYMBOLS =
+    SemanticExpressionTable::findSymbols(EXPRESSION_SYMBOLS);
+}  // namespace
+
+struct SemanticLL1Parser::Storage
 {
-    /**
-     * @note The syntax of arithmetic expressions:
-     *  S -> E {0}                  {0} : print(E.val)
-     *  E -> + E' {1}               {1} : E.syn = E'.syn
-     *  E -> - E' {2}               {2} : E.syn = -E'.syn
-     *  E -> E' {3}                 {3} : E.syn = E'.syn
-     *  E' -> T {4} E'' {5}         {4} : E''.inh = T.val
-     *                              {5} : E'.syn = E''.syn
-     *  E'' -> + T {6} E''1 {7}     {6} : E''1.inh = E''.inh + T.val
-     *                              {7} : E''.syn = E''1.syn
-     *  E'' -> - T {8} E''1 {9}     {8} : E''1.inh = E''.inh - T.val
-     *                              {9} : E''.syn = E''1.syn
-     *  E'' -> ε {10}               {10} : E''.syn = E''.inh
-     *  T -> F {11} T' {12}         {11} : T'.inh = F.val
-     *                              {12} : T.val = T'.syn
-     *  T' -> * F {13} T'1 {14}     {13} : T'1.inh = T'.inh * F.val
-     *                              {14} : T'.syn = T'1.syn
-     *  T' -> / F {15} T'1 {16}     {15} : if F.val == 0 then error
-     *                                     T'1.inh = T'.inh / F.val
-     *                              {16} : T'.syn = T'1.syn
-     *  T' -> ε {17}                {17} : T'.syn = T'.inh
-     *  F -> ( E {18} )             {18} : F.val = E.val
-     *  F -> id {19}                {19} : error
-     *  F -> num {20}               {20} : F.val = num.val
-     *
-     * {n} is the action symbol for semantic analysis.
-     */
-
-    m_analyzer.setBeginSym("S");
-
-    addRule("S", {"E", "0"});
-    addRule("E", {"+", "E'", "1"});
-    addRule("E", {"-", "E'", "2"});
-    addRule("E", {"E'", "3"});
-    addRule("E'", {"T", "4", "E''", "5"});
-    addRule("E''", {"+", "T", "6", "E''", "7"}, 3);
-    addRule("E''", {"-", "T", "8", "E''", "9"}, 3);
-    addRule("E''", {EPSILON, "10"}, 0);
-    addRule("T", {"F", "11", "T'", "12"});
-    addRule("T'", {"*", "F", "13", "T'", "14"}, 3);
-    addRule("T'", {"/", "F", "15", "T'", "16"}, 3);
-    addRule("T'", {EPSILON, "17"}, 0);
-    addRule("F", {"(", "E", "18", ")"});
-    addRule("F", {"id", "19"});
-    addRule("F", {"num", "20"});
-
-    m_analyzer.calcSelectSets();
-    generateTables();
-
-    setActionFunc("0", Action::print);
-    setActionFunc("1", Action::assign);
-    setActionFunc("2", Action::opposite);
-    setActionFunc("3", Action::assign);
-    setActionFunc("4", Action::assign);
-    setActionFunc("5", Action::assign);
-    setActionFunc("6", Action::add);
-    setActionFunc("7", Action::assign);
-    setActionFunc("8", Action::sub);
-    setActionFunc("9", Action::assign);
-    setActionFunc("10", Action::assign);
-    setActionFunc("11", Action::assign);
-    setActionFunc("12", Action::assign);
-    setActionFunc("13", Action::mul);
-    setActionFunc("14", Action::assign);
-    setActionFunc("15", Action::div);
-    setActionFunc("16", Action::assign);
-    setActionFunc("17", Action::assign);
-    setActionFunc("18", Action::assign);
-    setActionFunc("19", Action::assign);
-    setActionFunc("20", Action::assign);
+    std::vector<ActionFunc> actionFuncs;
+    std::vector<int> indexOffsets;
+};
+
+SemanticLL1Parser::SemanticLL1Parser(ExpressionEngine engine)
+    : m_predictionTable(SemanticExpressionTable::getPredictionTable()),
+      m_actionFuncs(SEMANTIC_EXPRESSION_ACTION_FUNCS),
+      m_indexOffsets(SemanticExpressionTable::getIndexOffsets()),
+      m_kindSymbols(SEMANTIC_EXPRESSION_KIND_SYMBOLS),
+      m_idSym(SemanticExpressionTable::findSymbol("id")),
+      m_numSym(SemanticExpressionTable::findSymbol("num"))
+{
+    if (engine == ExpressionEngine::Pratt) {
+        m_pratt.emplace(PrattParser::Mode::Semantics);
+    }
 }
 
-void SemanticLL1Parser::addRule(const Symbol& lhs, const std::vector<Symbol>& rhs, int indexOffset)
+SemanticLL1Parser::SemanticLL1Parser(const ParseTables& tables)
+    : m_predictionTable(tables.predictionTable)
 {
-    m_rhsWithActions.push_back(rhs);
-
-    /**
-     * @note The syntax analyzer can only handle rules without actions.
-     *      So, remove all the actions on the right-hand side of the rule.
-     */
+    const PredictionTable& table = m_predictionTable;
+    auto storage = std::make_shared<Storage>();
+    storage->actionFuncs.assign(table.getSymbolCount(), nullptr);
+    storage->indexOffsets = tables.indexOffsets;
+    for (const auto& [actionSym, function] : tables.actions) {
+        Action::Function func = Action::find(function);
+        if (!func) {
+            throw std::runtime_error(std::format("Action function {} does not exist", function));
+        }
+        SymbolId id = table.findSymbol(actionSym);
+        if (id == PredictionTable::NO_SYMBOL) {
+            throw std::runtime_error(std::format("Action {} does not exist", actionSym));
+        }
+        if (storage->actionFuncs[id]) {
+            throw std::runtime_error(std::format("Action {} already exists", actionSym));
+        }
+        storage->actionFuncs[id] = func;
+    }
 
-    std::vector<Symbol> rhsWithoutActions;
-    for (const Symbol& sym : rhs) {
-        /**
-         * @note An action symbol begins with a digit.
-         */
-        if (!std::isdigit(sym[0])) {
-            rhsWithoutActions.push_back(sym);
+    // The symbols after the terminals and non-terminals are actions.
+    for (size_t id = table.getTerminalCount() + table.getNonTerminalCount();
+         id < table.getSymbolCount(); ++id) {
+        if (!storage->actionFuncs[id]) {
+            throw std::runtime_error(
+                std::format("Action {} has no function", table.getName(static_cast<SymbolId>(id))));
         }
     }
-    m_analyzer.addRule(lhs, rhsWithoutActions);
 
-    // Store the index offset for the non-terminal symbol.
-    m_indexOffsets.push_back(indexOffset);
+    m_actionFuncs = storage->actionFuncs;
+    m_indexOffsets = storage->indexOffsets;
+    m_storage = std::move(storage);
+    initSymbols();
 }
 
-void SemanticLL1Parser::setActionFunc(const std::string& actionSym, const ActionFunc& func)
+void SemanticLL1Parser::initSymbols()
 {
-    if (m_actionFuncs.find(actionSym) != m_actionFuncs.end()) {
-        throw std::runtime_error(std::format("Action {} already exists", actionSym));
+    for (size_t kind = 0; kind < TOKEN_KIND_COUNT; ++kind) {
+        m_kindSymbols[kind] = m_predictionTable.findSymbol(EXPRESSION_SYMBOLS[kind]);
     }
-    m_actionFuncs[actionSym] = func;
+    m_idSym = m_predictionTable.findSymbol("id");
+    m_numSym = m_predictionTable.findSymbol("num");
 }
 
-void SemanticLL1Parser::generateTables()
+void SemanticLL1Parser::parse(TokenSource& tokens) const
 {
-    const auto& rules = m_analyzer.getRules();
-    for (size_t i = 0; i < rules.size(); ++i) {
-        const Symbol& lhs = rules[i].lhs;
-        const std::set<Symbol>& selectSet = m_analyzer.getSelectSet(i);
-
-        for (const Symbol& sym : selectSet) {
-            m_predictionTable[lhs][sym] = m_rhsWithActions[i];
-            m_indexOffsetTable[lhs][sym] = m_indexOffsets[i];
-        }
+    if (m_pratt) {
+        m_pratt->parse(tokens);
+        return;
+    }
+    analyze(tokens, nullptr);
+}
+
+void SemanticLL1Parser::parse(TokenSource& tokens, CompilationUnit& unit) const
+{
+    if (m_pratt) {
+        m_pratt->parse(tokens, unit);
+        return;
+    }
+    unit.reset(tokens.getSource());
+    ExpressionBuilder builder(unit, ExpressionBuilder::SignScope::Expression);
+    if (analyze(tokens, &builder)) {
+        unit.setRoot(builder.finish());
+    } else {
+        unit.reset(tokens.getSource());
     }
 }
 
-void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
+bool SemanticLL1Parser::analyze(TokenSource& tokens, ExpressionBuilder* builder) const
 {
     /**
-     * @note Input stack (The bottom is at index 0):
-     *   a + 5 * b  =>
-     *   ----------------------------
-     *   | ENDSYM  b  *  5 +  a <---
-     *   ----------------------------
+     * @note Instead of an input stack, only the value of the lookahead token is kept.
+     *      The tokens are pulled from the source one by one, and ENDSYM is used as the lookahead
+     *      once the source is exhausted:
+     *   a + 5 * b  =>  a  +  5  *  b  ENDSYM
+     *                  ^ lookahead
+     * @note Different from the LL1Parser,
+     *      the value of each number is needed in the semantic actions.
+     *      So we keep the lookahead token besides its symbol, which carries the value.
+     * @note The symbol is translated from the kind of the token once per token. The symbols
+     *      are IDs in the prediction table, so the loop compares and indexes integers only.
+     *      The names are looked up for diagnostics.
      */
-    std::vector<std::string> inputStack{ENDSYM};
-
-    // Push values of tokens in reverse order.
-    for (auto it = tokens.rbegin(); it != tokens.rend(); ++it) {
-        /**
-         * @note Different from the LL1Parser,
-         *      the value of each number is needed in the semantic actions.
-         *      So we cannot translate them to symbols here.
-         */
-        inputStack.push_back(it->value);
-    }
+    const PredictionTable& table = m_predictionTable;
+    Token token;
+    SymbolId itopSym;
+    uint32_t itopOffset = NO_OFFSET;  // The offset of the lookahead token, if it exists.
+    auto nextInput = [&]() {
+        if (!tokens.next(token)) {
+            itopSym = table.getEndSym();
+            itopOffset = NO_OFFSET;
+        } else if (token.type != TokenType::Invalid) {
+            itopSym = m_kindSymbols[static_cast<size_t>(token.kind)];
+            itopOffset = token.offset;
+        } else {
+            itopSym = table.findSymbol(translateExpressionSymbol(token));
+            itopOffset = token.offset;
+        }
+    };
+    auto itopName = [&]() -> std::string_view {
+        return itopOffset != NO_OFFSET ? translateExpressionSymbol(token)
+                                       : std::string_view(ENDSYM);
+    };
+    nextInput();
+    bool inputConsumed = false;  // Whether ENDSYM has been matched.
 
     /**
      * @note Analysis stack (The bottom is at index 0):
@@ -158,17 +226,13 @@ void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
      *    |  ENDSYM  Ssyn  S    <---
      *    --------------------
      */
-    std::vector<Element> analysisStack{Element(ENDSYM), Element(m_analyzer.getBeginSym(), true),
-                                       Element(m_analyzer.getBeginSym())};
+    std::vector<Element> analysisStack{{table.getEndSym(), SymbolType::ENDSYM},
+                                       {table.getBeginSym(), SymbolType::SYNTHESIZED},
+                                       {table.getBeginSym(), SymbolType::NON_TERMINAL}};
 
     try {
-        /**
-         * @note Translate the top symbol of the input stack here to avoid repeated translation.
-         */
-        Symbol itopSym = translate2Symbol(inputStack.back());
-
-        while (!analysisStack.empty() && !inputStack.empty()) {
-            // printState(analysisStack, inputStack);
+        while (!analysisStack.empty() && !inputConsumed) {
+            // printState(analysisStack, itopSym);
             size_t atopIndex = analysisStack.size() - 1;
             const Element& atop = analysisStack.back();
 
@@ -179,35 +243,40 @@ void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
             if (atop.type == SymbolType::TERMINAL || atop.type == SymbolType::ENDSYM) {
                 if (atop.symbol != itopSym) {  // Mismatch
                     throw SyntaxError(std::format(
-                        "The terminal symbol {} does not match the top of the input stack {}.",
-                        atop.symbol, itopSym));
+                        "{}The terminal symbol {} does not match the top of the input stack {}.",
+                        locate(tokens, itopOffset), table.getName(atop.symbol), itopName()));
                 }
 
-                if (atop.symbol == "id") {
+                if (atop.symbol == m_idSym) {
                     /**
                      * @note Values of identifiers are unknown, so the result cannot be calculated.
                      */
-                    throw SemanticError("Identifier is not allowed in the expression.");
+                    throw SemanticError(locate(tokens, itopOffset) +
+                                        "Identifier is not allowed in the expression.");
                 }
 
-                if (atop.symbol == "num") {
+                if (atop.symbol == m_numSym) {
                     /**
                      * @note Since only rule F -> num { F.val = num.val } can produce the terminal
                      * symbol "num", the next symbol of "num" must be action { F.val = num.val } So,
                      * assign the value of the number to the next symbol.
                      */
 
-                    int num = std::stoi(inputStack.back());  // Value of the number
-                    analysisStack[atopIndex - 1].values.push_back(num);
+                    if (token.outOfRange) {
+                        throw SemanticError(locate(tokens, itopOffset) + "Number out of range.");
+                    }
+                    analysisStack[atopIndex - 1].values.push_back(getNumberValue(token));
                 }
 
-                // Pop analysis stack and input stack.
+                // Pop analysis stack and move to the next input (if exists).
                 analysisStack.pop_back();
-                inputStack.pop_back();
-
-                // Update the top symbol of the input stack (if exists).
-                if (!inputStack.empty()) {
-                    itopSym = translate2Symbol(inputStack.back());
+                if (itopSym == table.getEndSym()) {
+                    inputConsumed = true;
+                } else {
+                    if (builder) {
+                        builder->push(token);
+                    }
+                    nextInput();
                 }
             } else if (atop.type == SymbolType::NON_TERMINAL) {
                 /**
@@ -216,40 +285,41 @@ void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
                  *     and replace X with Y1Y2...Yn (in reverse order) in the analysis stack.
                  */
 
-                const auto& items = m_predictionTable[atop.symbol];
-                if (items.find(itopSym) == items.end()) {  // No such production rule
-                    throw SyntaxError(std::format("{} is not allowed.", itopSym));
+                uint32_t rule = itopSym != PredictionTable::NO_SYMBOL
+                                    ? table.predict(atop.symbol, itopSym)
+                                    : PredictionTable::NO_RULE;
+                if (rule == PredictionTable::NO_RULE) {  // No such production rule
+                    throw SyntaxError(std::format("{}{} is not allowed.",
+                                                  locate(tokens, itopOffset), itopName()));
                 }
-                const auto& rhs = m_predictionTable[atop.symbol][itopSym];
+                std::span<const SymbolId> rhs = table.getRhs(rule);
 
                 // 1) Pop X
                 Element oldAtop = atop;
                 analysisStack.pop_back();
 
-                // 2) Push Yn, Yn-1, ..., Y1
+                // 2) Push Yn, Yn-1, ..., Y1 (ε is not stored in the table)
                 for (auto it = rhs.rbegin(); it != rhs.rend(); ++it) {
-                    if (*it != EPSILON) {  // Skip ε
-                        if (m_analyzer.isNonTerminal(*it)) {
-                            /**
-                             * @note If the symbol Y is a non-terminal, an additional synthesized
-                             *      attribute Ysyn should be pushed before Y.
-                             *      ---------------------
-                             *      |  ...  <-- Ysyn  Y
-                             *      ---------------------
-                             */
-                            analysisStack.push_back(Element(*it, true));  // Ysyn
-                        }
-                        analysisStack.push_back(Element(*it, false));
+                    if (table.isNonTerminal(*it)) {
+                        /**
+                         * @note If the symbol Y is a non-terminal, an additional synthesized
+                         *      attribute Ysyn should be pushed before Y.
+                         *      ---------------------
+                         *      |  ...  <-- Ysyn  Y
+                         *      ---------------------
+                         */
+                        analysisStack.push_back({*it, SymbolType::SYNTHESIZED});  // Ysyn
+                        analysisStack.push_back({*it, SymbolType::NON_TERMINAL});
+                    } else if (table.isTerminal(*it)) {
+                        analysisStack.push_back({*it, SymbolType::TERMINAL});
+                    } else {
+                        analysisStack.push_back({*it, SymbolType::ACTION});
                     }
                 }
 
                 // 3) Assign the value of X to the action that needs it.
                 if (oldAtop.values.size() == 1) {  // X has a value
-                    /**
-                     * @note It is safe to access m_indexOffsetTable[oldAtop.symbol][itopSym],
-                     *      because the corresponding rule is found.
-                     */
-                    int indexOffset = m_indexOffsetTable[oldAtop.symbol][itopSym];
+                    int indexOffset = m_indexOffsets[rule];
                     if (indexOffset != NULL_OFFSET) {  // The value needs to be passed
                         Element& e = analysisStack[atopIndex + indexOffset];  // Action
                         e.values.push_back(oldAtop.values[0]);
@@ -305,7 +375,7 @@ void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
                                        });
                 
                 // Perform the semantic action.
-                ActionFunc& action = m_actionFuncs[atop.symbol];
+                ActionFunc action = m_actionFuncs[atop.symbol];
                 int result = action(atop.values);
                 analysisStack.pop_back();
 
@@ -317,50 +387,37 @@ void SemanticLL1Parser::parse(const std::vector<Token>& tokens)
         }
     } catch (const SyntaxError& e) {
         Reporter::error(e.what());
-        return;
+        return false;
     } catch (const SemanticError& e) {
         Reporter::error(e.what());
-        return;
+        return false;
     }
 
     /**
-     * @note It is impossible that one of the stacks is empty while the other is not.
+     * @note It is impossible that the analysis stack is empty while the input is not consumed,
+     *      or the other way around.
      */
     Reporter::success("Syntax and semantics correct.");
+    return true;
 }
 
-void SemanticLL1Parser::printPredictionTable()
+void SemanticLL1Parser::printPredictionTable() const
 {
-    for (const auto& [lhs, item] : m_predictionTable) {
-        std::cout << lhs << " -- ";
-        for (const auto& [selectSym, rhs] : item) {
-            std::cout << selectSym << " -> ";
-            for (const auto& s : rhs) {
-                if (s == EPSILON) {
-                    std::cout << "ε";
-                } else if (std::isdigit(s[0])) {
-                    std::cout << "{" << s << "}";
-                } else {
-                    std::cout << s;
-                }
-            }
-            std::cout << ", ";
-        }
-        std::cout << "\n";
-    }
+    m_predictionTable.print();
 }
 
 void SemanticLL1Parser::printState(const std::vector<Element>& analysisStack,
-                                   const std::vector<std::string>& inputStack)
+                                   SymbolId lookahead) const
 {
     std::cout << "Analysis stack: ";
     for (const auto& sym : analysisStack) {
+        std::string_view name = m_predictionTable.getName(sym.symbol);
         if (sym.type == SymbolType::SYNTHESIZED) {
-            std::cout << sym.symbol << "syn ";
+            std::cout << name << "syn ";
         } else if (sym.type == SymbolType::ACTION) {
-            std::cout << "{" << sym.symbol << "} ";
+            std::cout << "{" << name << "} ";
         } else {
-            std::cout << sym.symbol << " ";
+            std::cout << name << " ";
         }
     }
     std::cout << "\n";
@@ -370,11 +427,10 @@ void SemanticLL1Parser::printState(const std::vector<Element>& analysisStack,
         std::cout << "Value: " << v << "\n";
     }
 
-    std::cout << "Input stack: ";
-    for (auto it = inputStack.rbegin(); it != inputStack.rend(); ++it) {
-        std::cout << translate2Symbol(*it) << " ";
-    }
-    std::cout << "\n";
+    std::cout << "Lookahead: "
+              << (lookahead != PredictionTable::NO_SYMBOL ? m_predictionTable.getName(lookahead)
+                                                          : "nul")
+              << "\n";
     std::cout << "--------------------------------------------------------------------------\n";
 }
 }  // namespace PL0
\ No newline at end of file
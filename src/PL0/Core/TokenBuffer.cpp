@@ -0,0 +1,97 @@
+#include "PL0/Core/TokenBuffer.hpp"
+
+#include <bit>
+
+namespace PL0
+{
+TokenBuffer::TokenBuffer(std::shared_ptr<const SourceBuffer> source,
+                         std::shared_ptr<const Interner> interner)
+    : m_source(std::move(source)), m_interner(std::move(interner))
+{
+}
+
+TokenBuffer::TokenBuffer(const TokenList& tokens)
+    : TokenBuffer(tokens.getSource(), tokens.getInterner())
+{
+    reserve(tokens.size());
+    for (const Token& token : tokens) {
+        push_back(token);
+    }
+}
+
+TokenBuffer::TokenBuffer(TokenSource& tokens, std::shared_ptr<const Interner> interner)
+    : TokenBuffer(tokens.getSource(), std::move(interner))
+{
+    if (m_source) {
+        reserve(m_source->size() / 4);  // A token takes about 4~5 bytes of source on average.
+    }
+    Token token;
+    while (tokens.next(token)) {
+        push_back(token);
+    }
+}
+
+void TokenBuffer::push_back(const Token& token)
+{
+    uint8_t kind = static_cast<uint8_t>(token.kind);
+    uint32_t payload = 0;
+    if (token.type == TokenType::Identifier) {
+        payload = token.id;
+    } else if (token.type == TokenType::Number) {
+        payload = std::bit_cast<uint32_t>(token.number);
+        kind |= token.outOfRange ? OUT_OF_RANGE : 0;
+    }
+
+    m_kinds.push_back(kind);
+    m_offsets.push_back(token.offset);
+    m_lengths.push_back(static_cast<uint32_t>(token.value.size()));
+    m_payloads.push_back(payload);
+}
+
+void TokenBuffer::reserve(size_t count)
+{
+    m_kinds.reserve(count);
+    m_offsets.reserve(count);
+    m_lengths.reserve(count);
+    m_payloads.reserve(count);
+}
+
+Token TokenBuffer::operator[](size_t index) const
+{
+    TokenKind kind = getKind(index);
+    Token token{.type = toType(kind), .kind = kind, .value = {}, .offset = m_offsets[index]};
+    uint32_t payload = m_payloads[index];
+    switch (token.type) {
+    case TokenType::Keyword: {
+        token.keyword = toKeyword(kind);
+        token.value = toString(token.keyword);
+        break;
+    }
+    case TokenType::Identifier: {
+        token.id = payload;
+        if (m_interner) {
+            token.value = m_interner->getString(payload);
+        } else {
+            token.value = {m_source->data() + token.offset, m_lengths[index]};
+        }
+        break;
+    }
+    case TokenType::Number: {
+        token.number = std::bit_cast<int32_t>(payload);
+        token.outOfRange = (m_kinds[index] & OUT_OF_RANGE) != 0;
+        [[fallthrough]];
+    }
+    default: {
+        token.value = {m_source->data() + token.offset, m_lengths[index]};
+        break;
+    }
+    }
+    return token;
+}
+
+size_t TokenBuffer::getMemoryUsage() const noexcept
+{
+    return m_kinds.capacity() * sizeof(uint8_t) + m_offsets.capacity() * sizeof(uint32_t) +
+           m_lengths.capacity() * sizeof(uint32_t) + m_payloads.capacity() * sizeof(uint32_t);
+}
+}  // namespace PL0
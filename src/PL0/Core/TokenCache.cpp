@@ -0,0 +1,277 @@
+#include "PL0/Core/TokenCache.hpp"
+
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace PL0
+{
+namespace
+{
+constexpr std::array<char, 8> MAGIC = {'P', 'L', '0', 'T', 'O', 'K', 'S', '\0'};
+constexpr uint32_t VERSION = 3;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t NO_ID = std::numeric_limits<uint32_t>::max();
+
+struct Header
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t byteOrder;   // BYTE_ORDER_MARK as written by the machine that stored the entry.
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+    uint32_t tokenCount;
+    uint32_t nameCount;   // The number of distinct identifiers.
+    uint64_t poolSize;    // The size of the string pool in bytes.
+};
+static_assert(sizeof(Header) % sizeof(uint32_t) == 0);
+
+/**
+ * @brief The position of each array in an entry.
+ * @note The 4-byte arrays come first, so they stay aligned after the header.
+ */
+struct Layout
+{
+    size_t offsets;
+    size_t lengths;
+    size_t ids;
+    size_t nameOffsets;  // nameCount + 1 entries, so name i is [nameOffsets[i], nameOffsets[i+1]).
+    size_t kinds;
+    size_t pool;
+    size_t size;  // The size of the entry.
+
+    Layout(uint64_t tokenCount, uint64_t nameCount, uint64_t poolSize)
+    {
+        offsets = sizeof(Header);
+        lengths = offsets + tokenCount * sizeof(uint32_t);
+        ids = lengths + tokenCount * sizeof(uint32_t);
+        nameOffsets = ids + tokenCount * sizeof(uint32_t);
+        kinds = nameOffsets + (nameCount + 1) * sizeof(uint32_t);
+        pool = kinds + tokenCount;
+        size = pool + poolSize;
+    }
+};
+
+inline uint64_t rotateLeft(uint64_t x, int bits)
+{
+    return (x << bits) | (x >> (64 - bits));
+}
+
+/**
+ * @brief The finalizer of MurmurHash3, which spreads every input bit over the output.
+ */
+inline uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+}  // namespace
+
+TokenCache::TokenCache(std::filesystem::path directory) : m_directory(std::move(directory))
+{
+}
+
+uint64_t TokenCache::hash(std::string_view text) noexcept
+{
+    /**
+     * @note The text is hashed 8 bytes at a time, so hashing is much faster than lexing and a
+     *      cache hit pays little for it.
+     */
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t h = PRIME1 ^ text.size();
+    const char* cur = text.data();
+    const char* end = cur + text.size();
+    for (; end - cur >= 8; cur += 8) {
+        uint64_t word;
+        std::memcpy(&word, cur, sizeof(word));
+        h = rotateLeft(h ^ (word * PRIME2), 31) * PRIME1;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, cur, end - cur);
+    h = rotateLeft(h ^ (tail * PRIME2), 31) * PRIME1;
+    return mix(h);
+}
+
+std::optional<TokenList> TokenCache::load(uint64_t key, std::shared_ptr<const SourceBuffer> source,
+                                          const std::shared_ptr<Interner>& interner) const
+{
+    std::filesystem::path path = getPath(key);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return std::nullopt;
+    }
+
+    std::unique_ptr<SourceBuffer> entry;
+    try {
+        entry = std::make_unique<SourceBuffer>(path.string());
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+
+    // Check the header
+    Header header;
+    if (entry->size() < sizeof(Header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, entry->data(), sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || header.sourceSize != source->size() ||
+        header.sourceHash != key) {
+        return std::nullopt;
+    }
+    Layout layout(header.tokenCount, header.nameCount, header.poolSize);
+    if (layout.size != entry->size()) {
+        return std::nullopt;
+    }
+
+    const char* base = entry->data();
+    auto offsets = reinterpret_cast<const uint32_t*>(base + layout.offsets);
+    auto lengths = reinterpret_cast<const uint32_t*>(base + layout.lengths);
+    auto ids = reinterpret_cast<const uint32_t*>(base + layout.ids);
+    auto nameOffsets = reinterpret_cast<const uint32_t*>(base + layout.nameOffsets);
+    auto kinds = reinterpret_cast<const uint8_t*>(base + layout.kinds);
+    const char* pool = base + layout.pool;
+
+    // Check every name and token before interning, so a bad entry leaves the interner unchanged
+    for (uint32_t i = 0; i < header.nameCount; ++i) {
+        if (nameOffsets[i] > nameOffsets[i + 1] || nameOffsets[i + 1] > header.poolSize) {
+            return std::nullopt;
+        }
+    }
+    for (uint32_t i = 0; i < header.tokenCount; ++i) {
+        if (kinds[i] >= TOKEN_KIND_COUNT || uint64_t(offsets[i]) + lengths[i] > source->size() ||
+            (toType(static_cast<TokenKind>(kinds[i])) == TokenType::Identifier &&
+             ids[i] >= header.nameCount)) {
+            return std::nullopt;
+        }
+    }
+
+    // Intern the names, which maps the IDs of the entry to the IDs of the interner
+    std::vector<uint32_t> idMap(header.nameCount);
+    for (uint32_t i = 0; i < header.nameCount; ++i) {
+        idMap[i] = interner->intern({pool + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]});
+    }
+
+    // Rebuild the tokens, writing each one once (resizing first would write the list twice)
+    TokenList tokens(source, interner);
+    tokens.reserve(header.tokenCount);
+    for (uint32_t i = 0; i < header.tokenCount; ++i) {
+        Token token;
+        auto kind = static_cast<TokenKind>(kinds[i]);
+        TokenType type = toType(kind);
+        std::string_view text(source->data() + offsets[i], lengths[i]);
+        if (type == TokenType::Keyword) {
+            Keyword keyword = toKeyword(kind);
+            token = {.type = type, .keyword = keyword, .kind = kind, .value = toString(keyword)};
+        } else if (type == TokenType::Identifier) {
+            uint32_t id = idMap[ids[i]];
+            token = {.type = type, .kind = kind, .id = id, .value = interner->getString(id)};
+        } else if (type == TokenType::Number) {
+            token = makeNumberToken(text);  // Decoding again is as cheap as storing the values
+        } else {
+            token = {.type = type, .kind = kind, .value = text};
+        }
+        token.offset = offsets[i];
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+void TokenCache::store(uint64_t key, const TokenList& tokens) const
+{
+    const std::shared_ptr<const Interner>& interner = tokens.getInterner();
+    if (!tokens.getSource() || tokens.size() > std::numeric_limits<uint32_t>::max()) {
+        return;
+    }
+
+    // Collect the distinct identifiers in the order they first appear
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.sourceSize = tokens.getSource()->size();
+    header.sourceHash = key;
+    header.tokenCount = static_cast<uint32_t>(tokens.size());
+
+    std::vector<uint32_t> idMap(interner ? interner->size() : 0, NO_ID);
+    std::vector<uint32_t> ids(tokens.size(), NO_ID);
+    std::vector<uint32_t> nameOffsets = {0};
+    std::string pool;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.type != TokenType::Identifier || token.keyword != Keyword::None) {
+            continue;
+        }
+        if (token.id >= idMap.size()) {
+            return;  // The IDs do not refer to the interner.
+        }
+        if (idMap[token.id] == NO_ID) {
+            idMap[token.id] = static_cast<uint32_t>(nameOffsets.size() - 1);
+            pool += token.value;  // In lowercase, as the lexer interned it
+            nameOffsets.push_back(static_cast<uint32_t>(pool.size()));
+        }
+        ids[i] = idMap[token.id];
+    }
+    header.nameCount = static_cast<uint32_t>(nameOffsets.size() - 1);
+    header.poolSize = pool.size();
+
+    std::vector<uint32_t> offsets(tokens.size());
+    std::vector<uint32_t> lengths(tokens.size());
+    std::vector<uint8_t> kinds(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        offsets[i] = tokens[i].offset;
+        lengths[i] = static_cast<uint32_t>(tokens[i].value.size());
+        kinds[i] = static_cast<uint8_t>(tokens[i].kind);
+    }
+
+    std::string body;
+    auto append = [&body](const auto& data, size_t size) {
+        body.append(reinterpret_cast<const char*>(data), size);
+    };
+    append(offsets.data(), offsets.size() * sizeof(uint32_t));
+    append(lengths.data(), lengths.size() * sizeof(uint32_t));
+    append(ids.data(), ids.size() * sizeof(uint32_t));
+    append(nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+    append(kinds.data(), kinds.size());
+    body += pool;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    std::filesystem::path path = getPath(key);
+    std::filesystem::path temporary = path;
+    temporary += std::format(".{:08x}.tmp", std::random_device()());
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+std::filesystem::path TokenCache::getPath(uint64_t key) const
+{
+    return m_directory / std::format("{:016x}.tokens", key);
+}
+}  // namespace PL0
@@ -0,0 +1,119 @@
+#include "PL0/Core/TokenDocument.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace PL0
+{
+TokenDocument::TokenDocument(const TokenList& tokens, std::shared_ptr<Interner> interner)
+    : m_interner(std::move(interner))
+{
+    if (!m_interner) {
+        throw std::invalid_argument("A document needs a table of identifiers.");
+    }
+    if (tokens.getInterner() && tokens.getInterner() != m_interner) {
+        throw std::invalid_argument("The tokens refer to another table of identifiers.");
+    }
+    std::string_view text = tokens.getSource() ? tokens.getSource()->view() : std::string_view();
+    m_segments = split(text, std::vector<Token>(tokens), 0);
+    m_size = text.size();
+    m_tokenCount = tokens.size();
+}
+
+SourceLocation TokenDocument::getLocation(size_t offset) const
+{
+    size_t index = findSegment(offset);
+    SourceLocation location = m_segments[index].text->getLocation(offset - m_segments[index].start);
+
+    // Count the lines of the segments before, and the columns until the line begins.
+    bool lineBegins = location.line > 1;
+    for (size_t i = index; i-- > 0;) {
+        std::string_view text = m_segments[i].text->view();
+        location.line += m_segments[i].lineBreaks;
+        if (!lineBegins) {
+            size_t lineBreak = text.rfind('\n');
+            lineBegins = lineBreak != std::string_view::npos;
+            location.column += static_cast<uint32_t>(lineBegins ? text.size() - lineBreak - 1
+                                                                : text.size());
+        }
+    }
+    return location;
+}
+
+TokenList TokenDocument::toTokenList() const
+{
+    std::string text;
+    text.reserve(m_size);
+    for (const Segment& segment : m_segments) {
+        text += segment.text->view();
+    }
+    std::shared_ptr<SourceBuffer> source = SourceBuffer::fromText(std::move(text));
+
+    TokenList tokens(source, m_interner);
+    tokens.reserve(m_tokenCount);
+    for (const Segment& segment : m_segments) {
+        for (Token token : segment.tokens) {
+            token.offset += static_cast<uint32_t>(segment.start);
+            if (token.type != TokenType::Keyword) {
+                token.value = {source->data() + token.offset, token.value.size()};
+            }
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+std::vector<TokenDocument::Segment> TokenDocument::split(std::string_view text,
+                                                         std::vector<Token>&& tokens, size_t start)
+{
+    std::vector<Segment> segments;
+    size_t begin = 0;       // The first byte of the next segment.
+    size_t firstToken = 0;  // The first token of the next segment.
+    auto cut = [&](size_t end, size_t lastToken) {
+        std::string_view part = text.substr(begin, end - begin);
+        Segment segment{.start = start + begin, .text = SourceBuffer::fromText(std::string(part))};
+        if (firstToken == 0 && lastToken == tokens.size()) {
+            segment.tokens = std::move(tokens);
+        } else {
+            segment.tokens.assign(tokens.begin() + firstToken, tokens.begin() + lastToken);
+        }
+
+        // Rebase the tokens on the segment, and point their values into its text. Identifiers
+        // from the token cache still have their original case in the source, so they are
+        // converted to lowercase in the copy, as lexing does.
+        SourceBuffer& copy = *segment.text;
+        for (Token& token : segment.tokens) {
+            token.offset -= static_cast<uint32_t>(begin);
+            if (token.type != TokenType::Keyword) {
+                token.value = {copy.data() + token.offset, token.value.size()};
+            }
+            if (token.type == TokenType::Identifier) {
+                copy.toLower(token.value);
+            }
+        }
+        segment.lineBreaks = static_cast<uint32_t>(std::ranges::count(segment.text->view(), '\n'));
+        segments.push_back(std::move(segment));
+        begin = end;
+        firstToken = lastToken;
+    };
+
+    // Cut where a token begins, once the segment is full, unless only a small rest is left.
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        size_t offset = tokens[i].offset;
+        if (offset - begin >= SEGMENT_SIZE && text.size() - offset >= SEGMENT_SIZE / 2) {
+            cut(offset, i);
+        }
+    }
+    cut(text.size(), tokens.size());
+    return segments;
+}
+
+size_t TokenDocument::findSegment(size_t offset) const
+{
+    auto after = std::ranges::partition_point(
+        m_segments, [offset](const Segment& segment) { return segment.start <= offset; });
+    return after - m_segments.begin() - 1;
+}
+}  // namespace PL0
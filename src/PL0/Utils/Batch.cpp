@@ -0,0 +1,165 @@
+#include "PL0/Utils/Batch.hpp"
+#include "PL0/Utils/Reporter.hpp"
+#include "PL0/Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace PL0
+{
+std::vector<std::string> listBatchFiles(const std::string& input)
+{
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> files;
+    std::error_code error;
+    if (fs::is_directory(input, error)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(input, error)) {
+            if (entry.is_regular_file(error)) {
+                files.push_back(entry.path().string());
+            }
+        }
+        if (error) {
+            throw std::runtime_error(std::format("Failed to read directory: {}", input));
+        }
+        std::ranges::sort(files);  // The order of a directory listing is unspecified.
+        return files;
+    }
+
+    std::ifstream manifest(input);
+    if (!manifest.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file: {}", input));
+    }
+    fs::path base = fs::path(input).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        // Trim the spaces, including the '\r' of a CRLF line ending
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r") + 1;
+        fs::path path = line.substr(begin, end - begin);
+        files.push_back((path.is_relative() ? base / path : path).string());
+    }
+    return files;
+}
+
+std::vector<std::string> getBatchOutputPaths(const std::vector<std::string>& files,
+                                             const std::string& outputDir)
+{
+    namespace fs = std::filesystem;
+
+    // The inputs as the outputs are compared with them: absolute, with the links resolved.
+    std::error_code error;
+    std::set<fs::path> inputs;
+    for (const std::string& file : files) {
+        fs::path input = fs::weakly_canonical(file, error);
+        if (!error) {
+            inputs.insert(std::move(input));
+        }
+    }
+
+    std::vector<std::string> outputs;
+    std::set<fs::path> names;
+    outputs.reserve(files.size());
+    for (const std::string& file : files) {
+        fs::path name = fs::path(file).filename();
+        if (!names.insert(name).second) {
+            throw std::runtime_error(
+                std::format("More than one file of the batch is named {}.", name.string()));
+        }
+        fs::path output = fs::path(outputDir) / name;
+        fs::path resolved = fs::weakly_canonical(output, error);
+        if ((!error && inputs.contains(resolved)) || fs::equivalent(output, file, error)) {
+            throw std::runtime_error(
+                std::format("The output {} would overwrite a file of the batch.", output.string()));
+        }
+        outputs.push_back(output.string());
+    }
+
+    fs::create_directories(outputDir, error);
+    if (error) {
+        throw std::runtime_error(std::format("Failed to create directory: {}", outputDir));
+    }
+    return outputs;
+}
+
+size_t runBatch(const std::vector<std::string>& files, size_t threadCount,
+                const std::function<void(size_t)>& process)
+{
+    struct Result
+    {
+        std::ostringstream messages;
+        bool failed = false;
+        bool done = false;
+    };
+    std::vector<Result> results(files.size());
+    std::mutex mutex;  // Guards Result::done.
+    std::condition_variable finished;
+
+    /**
+     * @note A worker runs the newest task of its queue first, so the files are submitted in
+     *      reverse order. Then they are mostly processed in order, and the output of each file
+     *      can be printed soon after it is done.
+     */
+    ThreadPool pool(threadCount);
+    for (size_t i = files.size(); i-- > 0;) {
+        pool.submit([&, i] {
+            Result& result = results[i];
+
+            // The file is marked done however the work ends, otherwise the loop below would wait
+            // for it forever. It is destroyed after the redirect, once the messages are complete.
+            struct DoneGuard
+            {
+                Result& result;
+                std::mutex& mutex;
+                std::condition_variable& finished;
+
+                ~DoneGuard()
+                {
+                    {
+                        std::lock_guard lock(mutex);
+                        result.done = true;
+                    }
+                    finished.notify_all();
+                }
+            } guard{result, mutex, finished};
+
+            Reporter::Redirect redirect(result.messages);
+            try {
+                process(i);
+            } catch (const std::exception& e) {
+                Reporter::error(e.what());
+                result.failed = true;
+            } catch (...) {
+                Reporter::error("Unknown error.");
+                result.failed = true;
+            }
+        });
+    }
+
+    size_t failedCount = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        Result& result = results[i];
+        {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&result] { return result.done; });
+        }
+        std::cout << std::format("Source file: {}\n", files[i]) << result.messages.view();
+        result.messages = std::ostringstream();  // Free the messages printed.
+        failedCount += result.failed ? 1 : 0;
+    }
+    std::cout.flush();
+    pool.wait();
+    return failedCount;
+}
+}  // namespace PL0
@@ -0,0 +1,26 @@
+#include "PL0/Utils/Interner.hpp"
+
+namespace PL0
+{
+uint32_t Interner::intern(std::string_view str)
+{
+    auto it = m_ids.find(str);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(m_strings.size());
+    const std::string& stored = m_strings.emplace_back(str);
+    m_ids.emplace(stored, id);
+    return id;
+}
+
+std::optional<uint32_t> Interner::find(std::string_view str) const
+{
+    auto it = m_ids.find(str);
+    if (it == m_ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+}  // namespace PL0
@@ -0,0 +1,118 @@
+#include "PL0/Utils/OutputFile.hpp"
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace PL0
+{
+OutputFile::OutputFile(const std::string& filename, size_t capacity)
+    : m_filename(filename), m_capacity(capacity > 0 ? capacity : 1)
+{
+#ifdef __linux__
+    m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+#else
+    m_stream.open(filename);
+    if (!m_stream.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+#endif
+    m_buffer.reserve(m_capacity);
+}
+
+OutputFile::~OutputFile()
+{
+    try {
+        close();
+    } catch (const std::runtime_error&) {
+    }
+}
+
+void OutputFile::writeNumber(int64_t value)
+{
+    std::array<char, 24> digits;
+    auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    write(std::string_view(digits.data(), end - digits.data()));
+}
+
+void OutputFile::flush()
+{
+    writeThrough({});
+}
+
+void OutputFile::close()
+{
+#ifdef __linux__
+    if (m_fd < 0) {
+        return;
+    }
+    flush();
+    int fd = m_fd;
+    m_fd = -1;
+    if (::close(fd) != 0) {
+        throw std::runtime_error("Failed to write file: " + m_filename);
+    }
+#else
+    if (!m_stream.is_open()) {
+        return;
+    }
+    flush();
+    m_stream.close();
+    if (!m_stream) {
+        throw std::runtime_error("Failed to write file: " + m_filename);
+    }
+#endif
+}
+
+void OutputFile::writeThrough(std::string_view str)
+{
+#ifdef __linux__
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to write file: " + m_filename);
+    }
+
+    std::array<iovec, 2> parts = {iovec{m_buffer.data(), m_buffer.size()},
+                                  iovec{const_cast<char*>(str.data()), str.size()}};
+    size_t first = 0;  // The first part that has not been written completely.
+    while (first < parts.size()) {
+        if (parts[first].iov_len == 0) {
+            ++first;
+            continue;
+        }
+        ssize_t written = ::writev(m_fd, parts.data() + first, static_cast<int>(parts.size() - first));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write file: " + m_filename);
+        }
+        // Skip the bytes written, which may end in the middle of a part.
+        for (size_t rest = static_cast<size_t>(written); rest > 0;) {
+            size_t skipped = std::min(rest, parts[first].iov_len);
+            parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + skipped;
+            parts[first].iov_len -= skipped;
+            rest -= skipped;
+            if (parts[first].iov_len == 0) {
+                ++first;
+            }
+        }
+    }
+#else
+    m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+    if (!m_stream) {
+        throw std::runtime_error("Failed to write file: " + m_filename);
+    }
+#endif
+    m_buffer.clear();
+}
+}  // namespace PL0
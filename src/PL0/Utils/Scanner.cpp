@@ -1,45 +1,35 @@
 #include "PL0/Utils/Scanner.hpp"
+#include "PL0/Utils/SimdScan.hpp"
 
 namespace PL0
 {
-Scanner::Scanner(const std::string& filename) : m_file(filename)
+Scanner::Scanner(const std::string& filename)
+    : Scanner(std::make_shared<SourceBuffer>(filename))
 {
-    if (!m_file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
-    }
-
-    // Set the cursor to the first character of the PL/0 source file.
-    forward();
-}
-
-Scanner::~Scanner()
-{
-    m_file.close();
 }
 
-void Scanner::forward()
+Scanner::Scanner(std::shared_ptr<SourceBuffer> source) : m_source(std::move(source))
 {
-    m_curChar = m_file.get();
+    // Set the cursor to the first character of the PL/0 source file.
+    m_cur = m_source->data();
+    m_end = m_cur + m_source->size();
 }
 
 void Scanner::skipSpaceAndComments()
 {
     while (true) {
         // Skip the spaces
-        while (std::isspace(m_curChar)) {
-            forward();
-        }
+        m_cur += skipSpaces(m_cur, m_end) - m_cur;
 
         // Skip the comments
         /**
          * @note The comments are enclosed by '{' and '}'.
          *       e.g. {This is a comment}
+         * @note Runs of spaces and comments are scanned with SIMD instructions if possible.
         */
-        if (m_curChar == '{') {
-            do {
-                forward();
-            } while (m_curChar != '}' && m_curChar != EOF);
-            if (m_curChar == '}') {
+        if (get() == '{') {
+            m_cur += findCommentEnd(m_cur + 1, m_end) - m_cur;
+            if (get() == '}') {
                 forward();
             }
         } else {
@@ -48,14 +38,8 @@ void Scanner::skipSpaceAndComments()
     }
 }
 
-std::string Scanner::getUntil(std::function<bool(char)> fn){
-    std::string str;
-
-    do {
-        str += m_curChar;
-        forward();
-    } while (fn(m_curChar));
-
-    return str;
+void Scanner::toLower(std::string_view str)
+{
+    m_source->toLower(str);
 }
-}  // namespace PL0
\ No newline at end of file
+}  // namespace PL0
@@ -0,0 +1,225 @@
+#include "PL0/Utils/SimdScan.hpp"
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PL0_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PL0_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PL0_TARGET_AVX2
+#endif
+
+namespace PL0
+{
+namespace
+{
+constexpr char COMMENT_END = '}';
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+const char* skipSpacesScalar(const char* cur, const char* end)
+{
+    while (cur != end && isSpaceChar(*cur)) {
+        ++cur;
+    }
+    return cur;
+}
+
+const char* findCommentEndScalar(const char* cur, const char* end)
+{
+    while (cur != end && *cur != COMMENT_END && *cur != static_cast<char>(EOF)) {
+        ++cur;
+    }
+    return cur;
+}
+
+#ifdef PL0_SIMD_X86
+
+inline int countTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// SSE2
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @note A byte c is a space if c == ' ' or (unsigned)(c - '\t') <= 4.
+ *      SSE2 has no unsigned byte comparison, so x <= 4 is computed as min(x, 4) == x.
+ */
+const char* skipSpacesSSE2(const char* cur, const char* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i range = _mm_set1_epi8('\r' - '\t');
+    while (end - cur >= 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        __m128i offset = _mm_sub_epi8(chars, tab);
+        __m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(chars, space),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(offset, range), offset));
+        uint32_t notSpace = ~static_cast<uint32_t>(_mm_movemask_epi8(isSpace)) & 0xFFFF;
+        if (notSpace != 0) {
+            return cur + countTrailingZeros(notSpace);
+        }
+        cur += 16;
+    }
+    return skipSpacesScalar(cur, end);
+}
+
+const char* findCommentEndSSE2(const char* cur, const char* end)
+{
+    const __m128i closing = _mm_set1_epi8(COMMENT_END);
+    const __m128i eof = _mm_set1_epi8(static_cast<char>(EOF));
+    while (end - cur >= 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi8(chars, closing), _mm_cmpeq_epi8(chars, eof));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0) {
+            return cur + countTrailingZeros(mask);
+        }
+        cur += 16;
+    }
+    return findCommentEndScalar(cur, end);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// AVX2
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+PL0_TARGET_AVX2 const char* skipSpacesAVX2(const char* cur, const char* end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i range = _mm256_set1_epi8('\r' - '\t');
+    while (end - cur >= 32) {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        __m256i offset = _mm256_sub_epi8(chars, tab);
+        __m256i isSpace =
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, space),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(offset, range), offset));
+        uint32_t notSpace = ~static_cast<uint32_t>(_mm256_movemask_epi8(isSpace));
+        if (notSpace != 0) {
+            return cur + countTrailingZeros(notSpace);
+        }
+        cur += 32;
+    }
+    return skipSpacesSSE2(cur, end);
+}
+
+PL0_TARGET_AVX2 const char* findCommentEndAVX2(const char* cur, const char* end)
+{
+    const __m256i closing = _mm256_set1_epi8(COMMENT_END);
+    const __m256i eof = _mm256_set1_epi8(static_cast<char>(EOF));
+    while (end - cur >= 32) {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+        __m256i found =
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, closing), _mm256_cmpeq_epi8(chars, eof));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+        if (mask != 0) {
+            return cur + countTrailingZeros(mask);
+        }
+        cur += 32;
+    }
+    return findCommentEndSSE2(cur, end);
+}
+
+bool cpuSupportsAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {  // The OS saves the YMM registers
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();  // May be called before the CPU features are initialized.
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // PL0_SIMD_X86
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Dispatch
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct ScanFunctions
+{
+    SimdLevel level;
+    const char* (*skipSpaces)(const char*, const char*);
+    const char* (*findCommentEnd)(const char*, const char*);
+};
+
+ScanFunctions selectFunctions(SimdLevel level)
+{
+#ifdef PL0_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        return {SimdLevel::AVX2, skipSpacesAVX2, findCommentEndAVX2};
+    }
+    if (level == SimdLevel::SSE2) {
+        return {SimdLevel::SSE2, skipSpacesSSE2, findCommentEndSSE2};
+    }
+#endif
+    return {SimdLevel::Scalar, skipSpacesScalar, findCommentEndScalar};
+}
+
+ScanFunctions g_functions = selectFunctions(detectSimdLevel());
+}  // namespace
+
+SimdLevel detectSimdLevel()
+{
+#ifdef PL0_SIMD_X86
+    // SSE2 is part of x86-64.
+    return cpuSupportsAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel getSimdLevel()
+{
+    return g_functions.level;
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    SimdLevel supported = detectSimdLevel();
+    g_functions = selectFunctions(level < supported ? level : supported);
+}
+
+namespace detail
+{
+const char* skipSpacesImpl(const char* cur, const char* end)
+{
+    return g_functions.skipSpaces(cur, end);
+}
+
+const char* findCommentEndImpl(const char* cur, const char* end)
+{
+    return g_functions.findCommentEnd(cur, end);
+}
+}  // namespace detail
+}  // namespace PL0
@@ -0,0 +1,136 @@
+#include "PL0/Utils/SourceBuffer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PL0
+{
+SourceBuffer::SourceBuffer(const std::string& filename)
+{
+#ifdef __linux__
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    /**
+     * @note Only regular, non-empty files are mapped.
+     *      Empty files cannot be mapped, and pipes or devices have no fixed size.
+     */
+    struct stat st;
+    bool regular = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (regular && static_cast<uint64_t>(st.st_size) > MAX_SIZE) {
+        ::close(fd);
+        checkSize(st.st_size, filename);
+    }
+    if (regular && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            m_data = static_cast<char*>(addr);
+            m_size = st.st_size;
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+
+    if (m_mapped) {
+        return;
+    }
+#endif
+    readWholeFile(filename);
+}
+
+SourceBuffer::~SourceBuffer()
+{
+#ifdef __linux__
+    if (m_mapped) {
+        ::munmap(m_data, m_size);
+    }
+#endif
+}
+
+std::shared_ptr<SourceBuffer> SourceBuffer::fromText(std::string text)
+{
+    checkSize(text.size(), "<text>");
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+    buffer->m_owned = std::move(text);
+    buffer->m_data = buffer->m_owned.data();
+    buffer->m_size = buffer->m_owned.size();
+    return buffer;
+}
+
+std::shared_ptr<SourceBuffer> SourceBuffer::fromStream(std::istream& stream)
+{
+    return fromText(std::string(std::istreambuf_iterator<char>(stream),
+                                std::istreambuf_iterator<char>()));
+}
+
+void SourceBuffer::readWholeFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    m_owned.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    checkSize(m_owned.size(), filename);
+    m_data = m_owned.data();
+    m_size = m_owned.size();
+    m_mapped = false;
+}
+
+void SourceBuffer::checkSize(size_t size, const std::string& name)
+{
+    if (size > MAX_SIZE) {
+        throw std::runtime_error(
+            std::format("The source is larger than 4 GiB ({} bytes): {}", size, name));
+    }
+}
+
+void SourceBuffer::toLower(std::string_view str)
+{
+    /**
+     * @note The view must point into this buffer, so the writable address can be recovered from
+     *      its offset. Characters that are already lowercase are not written, which keeps the
+     *      pages of a mapped file shared with the page cache.
+     */
+    char* begin = m_data + (str.data() - m_data);
+    for (char* p = begin; p != begin + str.size(); ++p) {
+        char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(*p)));
+        if (lower != *p) {
+            *p = lower;
+        }
+    }
+}
+
+SourceLocation SourceBuffer::getLocation(size_t offset) const
+{
+    std::call_once(m_lineStartsBuilt, [this] {
+        m_lineStarts.push_back(0);
+        const char* end = m_data + m_size;
+        for (const char* p = m_data; p != end; ++p) {
+            p = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (p == nullptr) {
+                break;
+            }
+            m_lineStarts.push_back(static_cast<uint32_t>(p + 1 - m_data));
+        }
+    });
+
+    // The last line that starts at or before the offset.
+    auto it = std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), offset) - 1;
+    return {static_cast<uint32_t>(it - m_lineStarts.begin() + 1),
+            static_cast<uint32_t>(offset - *it + 1)};
+}
+}  // namespace PL0
@@ -0,0 +1,141 @@
+#include "PL0/Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace PL0
+{
+namespace
+{
+/**
+ * @brief The pool of the worker running on the current thread, and the index of the worker.
+ */
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_queues.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_allDone.wait(lock, [this] { return m_pendingCount == 0; });
+        m_stopping = true;
+    }
+    m_taskReady.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    size_t index = currentPool == this ? currentWorker
+                                       : m_nextQueue.fetch_add(1) % m_queues.size();
+    /**
+     * @note The task is counted as pending before it is queued, so it cannot finish before it
+     *      is counted. It is counted as queued after, so a worker that reserves it finds it.
+     */
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_pendingCount;
+    }
+    {
+        std::lock_guard lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_queuedCount;
+    }
+    m_taskReady.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_allDone.wait(lock, [this] { return m_pendingCount == 0; });
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void ThreadPool::run(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_taskReady.wait(lock, [this] { return m_stopping || m_queuedCount > 0; });
+            if (m_queuedCount == 0) {  // Stopping, and no task is left.
+                return;
+            }
+            --m_queuedCount;  // Reserve one of the queued tasks for this worker.
+        }
+
+        /**
+         * @note A task is reserved above, so one is sure to be found, though another worker may
+         *      take the one in view first and make this worker look again.
+         */
+        Task task;
+        while (!take(index, task)) {
+            std::this_thread::yield();
+        }
+
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+
+        std::lock_guard lock(m_mutex);
+        if (--m_pendingCount == 0) {
+            m_allDone.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::take(size_t index, Task& task)
+{
+    // The newest task of its own queue, which is likely still hot in the cache.
+    {
+        Queue& queue = *m_queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // The oldest task of another queue, starting from the next worker.
+    for (size_t i = 1; i < m_queues.size(); ++i) {
+        Queue& queue = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace PL0
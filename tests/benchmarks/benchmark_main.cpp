@@ -0,0 +1,905 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PL0.hpp"
+
+// Generated by rdgen from the grammar files
+#include "ExpressionParser.hpp"
+#include "SemanticExpressionParser.hpp"
+
+namespace
+{
+struct Options
+{
+    std::string srcFile;  // The source file to lex.
+    size_t size;          // The size of generated inputs in bytes.
+    int repeat;           // The number of repetitions.
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Generate a syntactically plausible PL/0 program of about {size} bytes.
+ * @note The program contains no invalid tokens, so no diagnostics are printed while lexing it.
+ */
+std::string generateSource(size_t size)
+{
+    static const std::vector<std::string> words = {
+        "const", "VAR", "procedure", "Begin", "end", "if", "then", "while", "do", "call",
+        "odd",   "write", "read", "a", "b1", "Count", "total", "x", "Y2", "sum"};
+    static const std::vector<std::string> symbols = {"+", "-", "*", "/", "=", "#", "<", "<=",
+                                                     ">", ">=", ":=", "(", ")", ",", ";", "."};
+
+    std::mt19937 rng(2024);
+    std::string src;
+    src.reserve(size + 256);
+    while (src.size() < size) {
+        switch (rng() % 16) {
+        case 0: {
+            src += "{ This is a generated comment banner. }\n";
+            break;
+        }
+        case 1: {
+            src += "\n" + std::string(rng() % 16, ' ');
+            break;
+        }
+        default: {
+            src += "    ";
+            for (int i = 0, n = 4 + rng() % 12; i < n; ++i) {
+                unsigned kind = rng() % 3;
+                if (kind == 0) {
+                    src += words[rng() % words.size()];
+                } else if (kind == 1) {
+                    src += std::to_string(rng() % 100000);
+                } else {
+                    src += symbols[rng() % symbols.size()];
+                }
+                src += ' ';
+            }
+            src += '\n';
+            break;
+        }
+        }
+    }
+    return src;
+}
+
+/**
+ * @brief Run {fn} {repeat} times.
+ * @return The shortest time in seconds.
+ */
+double measure(const std::function<void()>& fn, int repeat)
+{
+    double best = 1e100;
+    for (int i = 0; i < repeat; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - begin).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Write {content} to a temporary file, which is removed when the object is destroyed.
+ */
+class TempFile
+{
+public:
+    TempFile(const std::string& name, const std::string& content)
+        : m_path(std::filesystem::temp_directory_path() / name)
+    {
+        std::ofstream(m_path, std::ios::binary) << content;
+    }
+    ~TempFile()
+    {
+        std::filesystem::remove(m_path);
+    }
+
+    std::string path() const
+    {
+        return m_path.string();
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+void report(const std::string& name, uintmax_t bytes, double seconds)
+{
+    std::cout << std::format("{:<32} {:>10.3f} ms {:>10.1f} MB/s\n", name, seconds * 1e3,
+                             bytes / seconds / 1e6);
+}
+
+bool sameTokens(const std::vector<PL0::Token>& lhs, const std::vector<PL0::Token>& rhs)
+{
+    return std::ranges::equal(lhs, rhs, [](const PL0::Token& a, const PL0::Token& b) {
+        return a.type == b.type && a.value == b.value && a.keyword == b.keyword &&
+               a.id == b.id && a.offset == b.offset && a.number == b.number &&
+               a.outOfRange == b.outOfRange && a.kind == b.kind;
+    });
+}
+
+/**
+ * @brief Generate an arithmetic expression of about {size} bytes.
+ * @note The value of the expression stays small, so it can be evaluated without overflow.
+ */
+std::string generateExpression(size_t size)
+{
+    std::mt19937 rng(2024);
+    std::string expr = "1";
+    expr.reserve(size + 64);
+    while (expr.size() < size) {
+        int n = 1 + rng() % 9;
+        switch (rng() % 4) {
+        case 0: {
+            expr += std::format(" + {} * 2 / 2", n);
+            break;
+        }
+        case 1: {
+            expr += std::format(" - {} * 2 / 2", n);
+            break;
+        }
+        case 2: {
+            expr += std::format(" + ({} - {})", n, n);
+            break;
+        }
+        default: {
+            expr += std::format("\n- {} + {}", n, n);
+            break;
+        }
+        }
+    }
+    return expr;
+}
+
+/**
+ * @brief Generate an arithmetic expression of about {size} bytes, whose operands are nested
+ *      {depth} levels deep in parentheses.
+ * @note Every other parenthesized expression is negated, and each one is closed by operators which
+ *      keep its magnitude, so the value of the expression stays small.
+ */
+std::string generateNestedExpression(size_t size, size_t depth)
+{
+    std::string expr = "1";
+    expr.reserve(size + depth * 16);
+    while (expr.size() < size) {
+        expr += "\n+ ";
+        for (size_t level = 0; level < depth; ++level) {
+            expr += level % 2 == 0 ? "(" : "-(";
+        }
+        expr += "1";
+        for (size_t level = 0; level < depth; ++level) {
+            expr += level % 2 == 0 ? ") * 2 / 2" : ") - 1 + 1";
+        }
+    }
+    return expr;
+}
+
+/**
+ * @brief Generate a syntactically correct PL/0 program of about {size} bytes, one statement or
+ *      declaration per line.
+ * @note The program is a sequence of procedures, each of which nests loops, conditions and
+ *      parenthesized expressions a few levels deep.
+ */
+std::string generateProgram(size_t size)
+{
+    std::mt19937 rng(2024);
+    std::string program = "const n = 100, m = 7;\nvar i, j, s;\n";
+    program.reserve(size + 256);
+    for (size_t p = 0; program.size() < size; ++p) {
+        program += std::format("procedure p{};\nvar t;\nbegin\n  t := 0;\n", p);
+        while (program.size() < size && rng() % 64 != 0) {
+            int n = 1 + rng() % 9;
+            switch (rng() % 5) {
+            case 0: {
+                program += std::format("  while t < n do\n  begin\n    t := t + {};\n"
+                                       "    s := (s + t) * {} / m\n  end;\n",
+                                       n, n);
+                break;
+            }
+            case 1: {
+                program += std::format("  if odd t then\n    t := -(t - {}) * (m + {});\n", n, n);
+                break;
+            }
+            case 2: {
+                program += std::format("  if t # {} then call p{};\n", n, p);
+                break;
+            }
+            case 3: {
+                program += "  read(i, j);\n  write(i + j, i * j);\n";
+                break;
+            }
+            default: {
+                program += std::format("  t := t + {} * (i - j);\n", n);
+                break;
+            }
+            }
+        }
+        program += "  s := s + t\nend;\n";
+    }
+    program += "begin\n  s := 0\nend.\n";
+    return program;
+}
+
+/**
+ * @brief Generate a grammar of {ruleCount} rules, whose begin symbol is N0.
+ * @note There are about 3 rules per non-terminal (N0, N1, ...) and a terminal (t0, t1, ...) per
+ *      4 rules. The right-hand sides refer to any non-terminal and some of them are ε, so the
+ *      FIRST and FOLLOW sets depend on each other through long chains and cycles.
+ */
+std::vector<PL0::Rule> generateGrammar(size_t ruleCount)
+{
+    std::mt19937 rng(2024);
+    size_t nonTerminalCount = std::max<size_t>(ruleCount / 3, 1);
+    size_t terminalCount = ruleCount / 4 + 8;
+
+    std::vector<PL0::Rule> rules;
+    rules.reserve(ruleCount);
+    for (size_t i = 0; i < ruleCount; ++i) {
+        size_t lhs = i < nonTerminalCount ? i : rng() % nonTerminalCount;
+        PL0::Rule rule{std::format("N{}", lhs), {}};
+        if (rng() % 8 == 0) {
+            rule.rhs.push_back(PL0::EPSILON);
+        } else {
+            for (size_t j = 0, n = 1 + rng() % 4; j < n; ++j) {
+                if (rng() % 3 == 0) {
+                    rule.rhs.push_back(std::format("t{}", rng() % terminalCount));
+                } else {
+                    rule.rhs.push_back(std::format("N{}", rng() % nonTerminalCount));
+                }
+            }
+        }
+        rules.push_back(std::move(rule));
+    }
+    return rules;
+}
+
+/**
+ * @brief Generate a grammar of about {ruleCount} rules made of two long chains, whose begin
+ *      symbol is N0.
+ * @note FIRST(A0) depends on A1, which depends on A2, and so on, but the rules of A0 come first.
+ *      FOLLOW(B{i+1}) depends on B{i}, but the rules of B{i+1} come first. So a sweep over the
+ *      rules in order moves each set one step along its chain.
+ */
+std::vector<PL0::Rule> generateChainGrammar(size_t ruleCount)
+{
+    size_t length = std::max<size_t>(ruleCount / 4, 1);
+    std::vector<PL0::Rule> rules = {{"N0", {"A0", "B0"}}};
+    for (size_t i = 0; i < length; ++i) {
+        rules.push_back(
+            {std::format("A{}", i), {std::format("A{}", i + 1), std::format("a{}", i % 16)}});
+        rules.push_back({std::format("A{}", i), {PL0::EPSILON}});
+    }
+    for (size_t i = length; i-- > 0;) {
+        rules.push_back(
+            {std::format("B{}", i), {std::format("b{}", i % 16), std::format("B{}", i + 1)}});
+        rules.push_back({std::format("B{}", i), {PL0::EPSILON}});
+    }
+    return rules;
+}
+
+/**
+ * @brief Generate an LL(1) grammar of expressions with {levels} levels of binary operators, in
+ *      the format of grammar files. Level i has its own operator o{i}.
+ */
+std::string generateExpressionGrammar(size_t levels)
+{
+    std::string text = "%begin E0\n";
+    for (size_t i = 0; i < levels; ++i) {
+        std::string next = i + 1 < levels ? std::format("E{}", i + 1) : "F";
+        text += std::format("E{0} -> {1} R{0}\nR{0} -> o{0} {1} R{0}\n   | ε\n", i, next);
+    }
+    text += "F -> ( E0 )\n   | id\n   | num\n";
+    return text;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Compare the throughput of the two lexer modes, of the table-driven mode on several
+ *      threads, and of loading the tokens from a warm token cache.
+ */
+void benchLexer(const Options& options)
+{
+    const std::string& srcFile = options.srcFile;
+    int repeat = options.repeat;
+    uintmax_t bytes = std::filesystem::file_size(srcFile);
+
+    PL0::TokenList reference;
+    auto check = [&](const std::string& name, const PL0::TokenList& tokens) {
+        if (reference.empty()) {
+            reference = tokens;
+        } else if (!sameTokens(reference, tokens)) {
+            PL0::Reporter::error(std::format("{} produced a different token stream.", name));
+        }
+    };
+
+    for (auto [name, mode] : {std::pair{"lexer/scanner", PL0::Lexer::Mode::Scanner},
+                              std::pair{"lexer/table-driven", PL0::Lexer::Mode::TableDriven}}) {
+        PL0::Lexer lexer(mode);
+        lexer.setThreadCount(1);
+        PL0::TokenList tokens;
+        double seconds = measure([&] { tokens = lexer.tokenize(srcFile); }, repeat);
+        report(name, bytes, seconds);
+        check(name, tokens);
+    }
+
+    size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threadCount = 2; threadCount <= std::max<size_t>(hardwareThreads, 4);
+         threadCount *= 2) {
+        std::string name = std::format("lexer/parallel/{}", threadCount);
+        PL0::Lexer lexer;
+        lexer.setThreadCount(threadCount);
+        PL0::TokenList tokens;
+        double seconds = measure([&] { tokens = lexer.tokenize(srcFile); }, repeat);
+        report(name, bytes, seconds);
+        check(name, tokens);
+    }
+
+    auto cacheDir = std::filesystem::temp_directory_path() / "pl0-benchmark-cache";
+    {
+        PL0::Lexer lexer;
+        lexer.setCacheDirectory(cacheDir.string());
+        PL0::TokenList tokens = lexer.tokenize(srcFile);  // Fill the cache
+        double seconds = measure([&] { tokens = lexer.tokenize(srcFile); }, repeat);
+        report("lexer/cached", bytes, seconds);
+        check("lexer/cached", tokens);
+    }
+    std::filesystem::remove_all(cacheDir);
+}
+
+/**
+ * @brief Compare lexing the same code held by each kind of source buffer: a mapped file, a file
+ *      read through a stream (as a pipe would be), and text which is already in memory.
+ * @note The time includes creating the buffer, e.g. mapping the file or copying the text.
+ */
+void benchSource(const Options& options)
+{
+    const std::string& srcFile = options.srcFile;
+    uintmax_t bytes = std::filesystem::file_size(srcFile);
+
+    std::string text;
+    {
+        std::ifstream file(srcFile, std::ios::binary);
+        text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    const std::vector<std::pair<std::string, std::function<std::shared_ptr<PL0::SourceBuffer>()>>>
+        sources = {
+            {"mapped", [&] { return std::make_shared<PL0::SourceBuffer>(srcFile); }},
+            {"stream",
+             [&] {
+                 std::ifstream file(srcFile, std::ios::binary);
+                 return PL0::SourceBuffer::fromStream(file);
+             }},
+            {"text", [&] { return PL0::SourceBuffer::fromText(text); }},
+        };
+
+    PL0::TokenList reference;
+    for (const auto& [name, makeSource] : sources) {
+        PL0::TokenList tokens;
+        double seconds = measure(
+            [&] {
+                PL0::Lexer lexer;
+                lexer.setThreadCount(1);
+                tokens = lexer.tokenize(makeSource());
+            },
+            options.repeat);
+        report(std::format("source/{}", name), bytes, seconds);
+        if (reference.empty()) {
+            reference = tokens;
+        } else if (!sameTokens(reference, tokens)) {
+            PL0::Reporter::error(std::format("source/{} produced a different token stream.", name));
+        }
+    }
+}
+
+/**
+ * @brief Compare calculating the SELECT sets of synthetic grammars in each mode of RuleAnalyzer.
+ */
+void benchGrammar(const Options& options)
+{
+    std::vector<std::pair<std::string, std::vector<PL0::Rule>>> grammars;
+    for (size_t ruleCount : {10, 100, 1000}) {
+        grammars.emplace_back(std::to_string(ruleCount), generateGrammar(ruleCount));
+    }
+    for (size_t ruleCount : {1000, 4000}) {
+        grammars.emplace_back(std::format("chain/{}", ruleCount), generateChainGrammar(ruleCount));
+    }
+
+    for (const auto& [grammar, rules] : grammars) {
+        std::vector<std::set<PL0::Symbol>> reference;
+        for (auto [name, mode] : {std::pair{"sets", PL0::RuleAnalyzer::Mode::Sets},
+                                  std::pair{"bitsets", PL0::RuleAnalyzer::Mode::Bitsets}}) {
+            PL0::RuleAnalyzer analyzer(mode);
+            double seconds = measure(
+                [&] {
+                    analyzer.clear();
+                    analyzer.setBeginSym("N0");
+                    for (const PL0::Rule& rule : rules) {
+                        analyzer.addRule(rule.lhs, rule.rhs);
+                    }
+                    analyzer.calcSelectSets();
+                },
+                options.repeat);
+            std::cout << std::format("{:<32} {:>10.3f} ms\n",
+                                     std::format("grammar/{}/{}", grammar, name), seconds * 1e3);
+
+            std::vector<std::set<PL0::Symbol>> selectSets;
+            for (size_t i = 0; i < rules.size(); ++i) {
+                selectSets.push_back(analyzer.getSelectSet(i));
+            }
+            if (reference.empty()) {
+                reference = std::move(selectSets);
+            } else if (selectSets != reference) {
+                PL0::Reporter::error(
+                    std::format("grammar/{}/{} produced different SELECT sets.", grammar, name));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compare building the parse tables of grammar files with loading them from their cache
+ *      files, and with building the parsers of the built-in grammars.
+ */
+void benchTables(const Options& options)
+{
+    auto print = [](const std::string& name, double seconds) {
+        std::cout << std::format("{:<32} {:>10.3f} ms\n", name, seconds * 1e3);
+    };
+    print("tables/builtin/ll1", measure([] { PL0::LL1Parser parser; }, options.repeat));
+    print("tables/builtin/semantic-ll1",
+          measure([] { PL0::SemanticLL1Parser parser; }, options.repeat));
+
+    for (size_t levels : {10, 100, 300}) {
+        std::string text = generateExpressionGrammar(levels);
+        TempFile grammarFile(std::format("pl0-benchmark-{}.grammar", levels), text);
+        std::filesystem::path cacheFile = grammarFile.path() + ".tables";
+        std::filesystem::remove(cacheFile);
+
+        PL0::ParseTables built;
+        double seconds = measure(
+            [&] { built = PL0::ParseTables::build(PL0::Grammar::parse(text)); }, options.repeat);
+        print(std::format("tables/{}/build", levels), seconds);
+
+        built.storeCache(cacheFile, text);
+        PL0::ParseTables loaded;
+        seconds = measure([&] { loaded = PL0::ParseTables::load(grammarFile.path()); },
+                          options.repeat);
+        print(std::format("tables/{}/cache", levels), seconds);
+
+        const PL0::PredictionTable& lhs = built.predictionTable;
+        const PL0::PredictionTable& rhs = loaded.predictionTable;
+        if (!std::ranges::equal(lhs.getNames(), rhs.getNames()) ||
+            !std::ranges::equal(lhs.getCells(), rhs.getCells()) ||
+            !std::ranges::equal(lhs.getRhsOffsets(), rhs.getRhsOffsets()) ||
+            !std::ranges::equal(lhs.getRhsPool(), rhs.getRhsPool()) ||
+            built.indexOffsets != loaded.indexOffsets) {
+            PL0::Reporter::error(std::format("tables/{}/cache loaded different tables.", levels));
+        }
+        std::filesystem::remove(cacheFile);
+    }
+}
+
+/**
+ * @brief Compare dumping the tokens as exp02 does, through a std::ofstream flushed by std::endl
+ *      per token and through an OutputFile.
+ */
+void benchDump(const Options& options)
+{
+    PL0::Lexer lexer;
+    PL0::TokenList tokens = lexer.tokenize(options.srcFile);
+    auto directory = std::filesystem::temp_directory_path();
+    std::string streamFile = (directory / "pl0-benchmark-dump-stream.txt").string();
+    std::string bufferedFile = (directory / "pl0-benchmark-dump-buffered.txt").string();
+
+    double seconds = measure(
+        [&] {
+            std::ofstream output(streamFile);
+            for (const PL0::Token& token : tokens) {
+                output << std::format("({}, {})", PL0::Lexer::encode(token), token.value)
+                       << std::endl;
+            }
+        },
+        options.repeat);
+    uintmax_t bytes = std::filesystem::file_size(streamFile);
+    report("dump/ofstream", bytes, seconds);
+
+    seconds = measure(
+        [&] {
+            PL0::OutputFile output(bufferedFile);
+            for (const PL0::Token& token : tokens) {
+                output.write('(');
+                output.write(PL0::Lexer::encode(token));
+                output.write(", ");
+                output.write(token.value);
+                output.write(")\n");
+            }
+            output.close();
+        },
+        options.repeat);
+    report("dump/output-file", bytes, seconds);
+
+    PL0::SourceBuffer expected(streamFile);
+    PL0::SourceBuffer actual(bufferedFile);
+    if (expected.view() != actual.view()) {
+        PL0::Reporter::error("dump/output-file produced a different dump.");
+    }
+    std::filesystem::remove(streamFile);
+    std::filesystem::remove(bufferedFile);
+}
+
+/**
+ * @brief Measure re-lexing the source after small edits in the middle of it, compared with
+ *      lexing the whole edited source again.
+ */
+void benchRelex(const Options& options)
+{
+    PL0::Lexer lexer;
+    auto interner = std::make_shared<PL0::Interner>();
+    PL0::TokenList tokens = lexer.tokenize(options.srcFile, interner);
+    std::string_view text = tokens.getSource()->view();
+    size_t middle = text.find('\n', text.size() / 2) + 1;
+
+    const std::vector<std::pair<std::string, PL0::SourceEdit>> edits = {
+        {"insert", {middle, 0, "x := x + 1;\n"}},
+        {"remove", {middle, std::min<size_t>(8, text.size() - middle), ""}},
+        {"open-comment", {middle, 0, "{"}},
+        {"close-comment", {middle, 0, "}"}},
+    };
+    for (const auto& [name, edit] : edits) {
+        // Each run applies the edit and undoes it, so every run starts from the same document.
+        PL0::TokenDocument document(tokens, interner);
+        PL0::SourceEdit undo = {edit.offset, edit.inserted.size(),
+                                std::string(text.substr(edit.offset, edit.removed))};
+        double seconds = measure(
+            [&] {
+                lexer.relex(document, edit);
+                lexer.relex(document, undo);
+            },
+            options.repeat);
+        report(std::format("relex/{}", name), text.size(), seconds / 2);
+
+        lexer.relex(document, edit);
+        PL0::TokenList relexed = document.toTokenList();
+        TempFile edited("pl0-benchmark-edited.pl0", std::string(relexed.getSource()->view()));
+        PL0::TokenList expected;
+        seconds = measure([&] { expected = lexer.tokenize(edited.path(), interner); },
+                          options.repeat);
+        report(std::format("relex/{}/full", name), text.size(), seconds);
+        if (!sameTokens(expected, relexed)) {
+            PL0::Reporter::error(std::format("relex/{} produced a different token stream.", name));
+        }
+    }
+
+    // The tokens loaded from the token cache must be re-lexed as those of a fresh run.
+    auto cacheDir = std::filesystem::temp_directory_path() / "pl0-benchmark-relex-cache";
+    lexer.setCacheDirectory(cacheDir.string());
+    TempFile file("pl0-benchmark-relex-cached.pl0", "VAR XyZ;\nBEGIN XyZ := 1 END.\n");
+    lexer.tokenize(file.path());  // Fill the cache
+    interner = std::make_shared<PL0::Interner>();
+    PL0::TokenDocument document(lexer.tokenize(file.path(), interner), interner);
+    lexer.relex(document, {0, 0, "CONST N = 2;\n"});
+    PL0::TokenList relexed = document.toTokenList();
+    TempFile edited("pl0-benchmark-relex-edited.pl0", std::string(relexed.getSource()->view()));
+    if (!sameTokens(lexer.tokenize(edited.path(), interner), relexed)) {
+        PL0::Reporter::error("relex/cached produced a different token stream.");
+    }
+    std::filesystem::remove_all(cacheDir);
+}
+
+/**
+ * @brief Compare parsing a materialized token list, a lazy token stream and a token buffer.
+ * @note Both include the time of lexing.
+ */
+void benchParse(const Options& options)
+{
+    TempFile file("pl0-benchmark-expression.pl0", generateExpression(options.size));
+    uintmax_t bytes = std::filesystem::file_size(file.path());
+
+    auto run = [&](const std::string& name, PL0::Parser& parser) {
+        size_t tokenBytes = 0;
+        double seconds = measure(
+            [&] {
+                PL0::Lexer lexer;
+                PL0::TokenList tokens = lexer.tokenize(file.path());
+                tokenBytes = tokens.capacity() * sizeof(PL0::Token);
+                parser.parse(tokens);
+            },
+            options.repeat);
+        report(std::format("parse/{}/vector", name), bytes, seconds);
+
+        seconds = measure(
+            [&] {
+                PL0::TokenStream stream = PL0::Lexer().stream(file.path());
+                parser.parse(stream);
+            },
+            options.repeat);
+        report(std::format("parse/{}/stream", name), bytes, seconds);
+
+        size_t bufferBytes = 0;
+        seconds = measure(
+            [&] {
+                PL0::TokenStream stream = PL0::Lexer().stream(file.path());
+                PL0::TokenBuffer buffer(stream, stream.getInterner());
+                bufferBytes = buffer.getMemoryUsage();
+                parser.parse(buffer);
+            },
+            options.repeat);
+        report(std::format("parse/{}/buffer", name), bytes, seconds);
+        std::cout << std::format("{:<32} {:>10.1f} MB\n", "  token list held by vector",
+                                 tokenBytes / 1e6);
+        std::cout << std::format("{:<32} {:>10.1f} MB\n", "  token list held by buffer",
+                                 bufferBytes / 1e6);
+    };
+
+    PL0::LL1Parser ll1;
+    run("ll1", ll1);
+    PL0::SemanticLL1Parser semantic;
+    run("semantic-ll1", semantic);
+}
+
+/**
+ * @brief Compare the table-driven parsers with the recursive-descent parsers generated from the
+ *      grammar files by rdgen.
+ * @note The tokens are read before, so only parsing is measured. The messages of the parsers are
+ *      collected to check that they agree.
+ */
+void benchGenerated(const Options& options)
+{
+    TempFile file("pl0-benchmark-expression.pl0", generateExpression(options.size));
+    uintmax_t bytes = std::filesystem::file_size(file.path());
+    PL0::Lexer lexer;
+    PL0::TokenList tokens = lexer.tokenize(file.path());
+
+    auto run = [&](const std::string& name, const PL0::Parser& parser) {
+        std::ostringstream messages;
+        PL0::Reporter::Redirect redirect(messages);
+        double seconds = measure([&] { parser.parse(tokens); }, options.repeat);
+        report(std::format("generated/{}", name), bytes, seconds);
+        return messages.str();
+    };
+
+    std::string interpreted = run("ll1/table", PL0::LL1Parser(PL0::ExpressionEngine::Table));
+    if (run("ll1/generated", PL0::Generated::ExpressionParser()) != interpreted) {
+        PL0::Reporter::error("The generated parser of expression.grammar disagrees.");
+    }
+    interpreted =
+        run("semantic-ll1/table", PL0::SemanticLL1Parser(PL0::ExpressionEngine::Table));
+    if (run("semantic-ll1/generated", PL0::Generated::SemanticExpressionParser()) != interpreted) {
+        PL0::Reporter::error("The generated parser of semantic-expression.grammar disagrees.");
+    }
+}
+
+/**
+ * @brief Compare PrattParser with the table-driven loop as the engine of the built-in grammars:
+ *      on a flat expression, on operands nested a few levels deep, and on operands nested deeper
+ *      than RecursiveDescentParser allows.
+ * @note The tokens are read before, so only parsing is measured. The messages of the engines are
+ *      collected to check that they agree.
+ */
+void benchPratt(const Options& options)
+{
+    size_t deepDepth = 4 * PL0::RecursiveDescentParser::MAX_DEPTH;
+    const std::pair<std::string, std::string> inputs[] = {
+        {"flat", generateExpression(options.size)},
+        {"nested", generateNestedExpression(options.size, 16)},
+        {"deep", generateNestedExpression(options.size, deepDepth)},
+    };
+    for (const auto& [input, content] : inputs) {
+        TempFile file("pl0-benchmark-expression.pl0", content);
+        uintmax_t bytes = std::filesystem::file_size(file.path());
+        PL0::Lexer lexer;
+        PL0::TokenList tokens = lexer.tokenize(file.path());
+
+        auto run = [&](const std::string& name, const PL0::Parser& parser) {
+            std::ostringstream messages;
+            PL0::Reporter::Redirect redirect(messages);
+            double seconds = measure([&] { parser.parse(tokens); }, options.repeat);
+            report(std::format("pratt/{}/{}", input, name), bytes, seconds);
+            return messages.str();
+        };
+
+        std::string table = run("ll1/table", PL0::LL1Parser(PL0::ExpressionEngine::Table));
+        if (run("ll1/pratt", PL0::LL1Parser(PL0::ExpressionEngine::Pratt)) != table) {
+            PL0::Reporter::error(std::format("The engines of LL1Parser disagree on {}.", input));
+        }
+        table = run("semantic-ll1/table", PL0::SemanticLL1Parser(PL0::ExpressionEngine::Table));
+        if (run("semantic-ll1/pratt", PL0::SemanticLL1Parser(PL0::ExpressionEngine::Pratt)) !=
+            table) {
+            PL0::Reporter::error(
+                std::format("The engines of SemanticLL1Parser disagree on {}.", input));
+        }
+    }
+}
+
+/**
+ * @brief Check the syntax of a whole generated program with RecursiveDescentParser.
+ * @note The tokens are read before for parse/rd/vector, so only parsing is measured, while
+ *      parse/rd/stream lexes and parses in one pass.
+ */
+void benchProgram(const Options& options)
+{
+    std::string program = generateProgram(options.size);
+    size_t lineCount = std::ranges::count(program, '\n');
+    TempFile file("pl0-benchmark-program.pl0", program);
+    uintmax_t bytes = std::filesystem::file_size(file.path());
+    std::cout << std::format("{:<32} {:>10} lines\n", "program", lineCount);
+
+    PL0::RecursiveDescentParser parser;
+    std::ostringstream messages;
+    auto run = [&](const std::string& name, const std::function<void()>& fn) {
+        PL0::Reporter::Redirect redirect(messages);
+        report(name, bytes, measure(fn, options.repeat));
+    };
+
+    PL0::Lexer lexer;
+    PL0::TokenList tokens = lexer.tokenize(file.path());
+    run("program/rd/vector", [&] { parser.parse(tokens); });
+    run("program/rd/stream", [&] {
+        PL0::TokenStream stream = PL0::Lexer().stream(file.path());
+        parser.parse(stream);
+    });
+
+    if (messages.str().find("Syntax error") != std::string::npos) {
+        PL0::Reporter::error("The generated program is rejected.");
+    }
+}
+
+/**
+ * @brief Measure the cost of building the syntax tree, against parsing without it.
+ * @note The tokens are read before, so only parsing is measured. The unit is reused, so the
+ *      chunks of its arena are only allocated by the first repetition.
+ * @note The tree should cost less than 20% of the parse time.
+ */
+void benchAst(const Options& options)
+{
+    TempFile expression("pl0-benchmark-expression.pl0", generateExpression(options.size));
+    TempFile program("pl0-benchmark-program.pl0", generateProgram(options.size));
+
+    auto run = [&](const std::string& name, const std::string& file, const PL0::Parser& parser) {
+        uintmax_t bytes = std::filesystem::file_size(file);
+        PL0::Lexer lexer;
+        PL0::TokenList tokens = lexer.tokenize(file);
+        PL0::CompilationUnit unit;
+        double parseSeconds = 0;
+        double buildSeconds = 0;
+        {
+            std::ostringstream messages;
+            PL0::Reporter::Redirect redirect(messages);
+            parseSeconds = buildSeconds = 1e100;
+            for (int i = 0; i < options.repeat; ++i) {  // Alternately, so noise hits both alike
+                parseSeconds = std::min(parseSeconds, measure([&] { parser.parse(tokens); }, 1));
+                buildSeconds =
+                    std::min(buildSeconds, measure([&] { parser.parse(tokens, unit); }, 1));
+            }
+        }
+        report(std::format("ast/{}/parse", name), bytes, parseSeconds);
+        report(std::format("ast/{}/build", name), bytes, buildSeconds);
+        std::cout << std::format("{:<32} {:>10} nodes {:>7.1f} MB {:>+7.1f}%\n", "  tree",
+                                 unit.getNodeCount(), unit.getMemoryUsage() / 1e6,
+                                 (buildSeconds / parseSeconds - 1) * 100);
+        if (unit.getRoot() == PL0::NO_NODE) {
+            PL0::Reporter::error(std::format("No tree is built by {}.", name));
+        }
+    };
+
+    run("ll1", expression.path(), PL0::LL1Parser());
+    run("semantic-ll1", expression.path(), PL0::SemanticLL1Parser());
+    run("rd", program.path(), PL0::RecursiveDescentParser());
+}
+
+/**
+ * @brief Measure Scanner::skipSpaceAndComments on comment-heavy and space-heavy inputs with each
+ *      SIMD level.
+ */
+void benchSkip(const Options& options)
+{
+    std::string banner = "{" + std::string(78, '*') + "}\n{ Generated by the benchmark." +
+                         std::string(48, ' ') + "}\n";
+    std::string comments;
+    while (comments.size() < options.size) {
+        comments += banner;
+    }
+
+    std::string indent = "\n\n" + std::string(12, ' ') + "\t\t\r\n" + std::string(3, ' ');
+    std::string spaces;
+    while (spaces.size() < options.size) {
+        spaces += indent;
+    }
+
+    PL0::SimdLevel best = PL0::detectSimdLevel();
+    for (auto [kind, content] : {std::pair{"comments", &comments}, std::pair{"spaces", &spaces}}) {
+        TempFile file(std::format("pl0-benchmark-{}.pl0", kind), *content);
+        auto source = std::make_shared<PL0::SourceBuffer>(file.path());
+
+        for (auto [name, level] : {std::pair{"scalar", PL0::SimdLevel::Scalar},
+                                   std::pair{"sse2", PL0::SimdLevel::SSE2},
+                                   std::pair{"avx2", PL0::SimdLevel::AVX2}}) {
+            if (level > best) {
+                continue;
+            }
+            PL0::setSimdLevel(level);
+            double seconds = measure(
+                [&] {
+                    PL0::Scanner scanner(source);
+                    scanner.skipSpaceAndComments();
+                    if (scanner.get() != EOF) {
+                        PL0::Reporter::error("The scanner stopped before the end of the input.");
+                    }
+                },
+                options.repeat);
+            report(std::format("skip/{}/{}", kind, name), source->size(), seconds);
+        }
+    }
+    PL0::setSimdLevel(best);
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::map<std::string, std::function<void(const Options&)>> benchmarks = {
+        {"ast", benchAst},
+        {"dump", benchDump},
+        {"generated", benchGenerated},
+        {"grammar", benchGrammar},
+        {"lexer", benchLexer},
+        {"parse", benchParse},
+        {"pratt", benchPratt},
+        {"program", benchProgram},
+        {"relex", benchRelex},
+        {"skip", benchSkip},
+        {"source", benchSource},
+        {"tables", benchTables},
+    };
+
+    PL0::ArgParser argParser;
+    argParser.addOption("t", "The benchmark to run (all by default)", "string", "all");
+    argParser.addOption("f", "The source file (a synthetic one by default)", "string");
+    argParser.addOption("s", "The size of the synthetic source file in MB", "int", "32");
+    argParser.addOption("r", "The number of repetitions", "int", "3");
+    if (!argParser.parse(argc, argv)) {
+        return 1;
+    }
+
+    std::string target = *(argParser.get<std::string>("t"));
+
+    Options options;
+    options.size = static_cast<size_t>(*(argParser.get<int>("s"))) << 20;
+    options.repeat = *(argParser.get<int>("r"));
+
+    std::unique_ptr<TempFile> generated;
+    if (auto file = argParser.get<std::string>("f")) {
+        options.srcFile = *file;
+    } else {
+        generated = std::make_unique<TempFile>("pl0-benchmark.pl0", generateSource(options.size));
+        options.srcFile = generated->path();
+    }
+    std::cout << std::format("Source file: {} ({} bytes)\n", options.srcFile,
+                             std::filesystem::file_size(options.srcFile));
+
+    for (const auto& [name, bench] : benchmarks) {
+        if (target == "all" || target == name) {
+            bench(options);
+        }
+    }
+}
@@ -1,41 +1,38 @@
 #include <algorithm>
-#include <format>
-#include <fstream>
 #include <string>
 #include <vector>
 
 #include "PL0.hpp"
 
-struct IdentInfo
-{
-    std::string ident = "";
-    uint64_t count = 0;
-};
-
 void recognizeIdent(const std::string& srcFile, const std::string& outputFile)
 {
     PL0::Lexer lexer;
-    std::vector<PL0::Token> tokens = lexer.tokenize(srcFile);
+    PL0::TokenList tokens = lexer.tokenize(srcFile);
 
-    std::vector<IdentInfo> identifiers;
+    /**
+     * @note Identifiers are counted by their IDs in the interner of the token list,
+     *      and printed in the order they first appear.
+     */
+    std::vector<uint64_t> counts;
+    std::vector<uint32_t> order;
     for (const PL0::Token& token : tokens) {
         if (token.type == PL0::TokenType::Identifier) {
-            auto it = std::ranges::find_if(
-                identifiers, [&token](const IdentInfo& info) { return info.ident == token.value; });
-            if (it == identifiers.end()) {
-                identifiers.push_back({token.value, 1});
-            } else {
-                it->count++;
+            if (token.id >= counts.size()) {
+                counts.resize(token.id + 1, 0);
+            }
+            if (counts[token.id]++ == 0) {
+                order.push_back(token.id);
             }
         }
     }
 
-    std::ofstream output(outputFile);
-    if (!output.is_open()) {
-        throw std::runtime_error(std::format("Failed to open file: {}", outputFile));
-    }
-    for (const auto& [ident, count] : identifiers) {
-        output << std::format("({}: {})", ident, count) << std::endl;
+    PL0::OutputFile output(outputFile);
+    for (uint32_t id : order) {
+        output.write('(');
+        output.write(tokens.getInterner()->getString(id));
+        output.write(": ");
+        output.writeNumber(static_cast<int64_t>(counts[id]));
+        output.write(")\n");
     }
     output.close();
 }
@@ -44,13 +41,34 @@ int main(int argc, char* argv[])
 {
     PL0::ArgParser argParser;
     argParser.addOption("f", "The source file to be compiled", "string");
-    argParser.addOption("o", "The output file", "string", "a.out");
+    argParser.addOption("o", "The output file (the output directory in batch mode)", "string",
+                        "a.out");
+    argParser.addOption("b", "A directory or a manifest file of source files to compile in batch",
+                        "string");
+    argParser.addOption("j", "The number of threads in batch mode (0 for one per hardware thread)",
+                        "int", "0");
     argParser.parse(argc, argv);
 
+    std::string outputFile = *(argParser.get<std::string>("o"));
+
+    if (auto batch = argParser.get<std::string>("b")) {
+        std::vector<std::string> srcFiles = PL0::listBatchFiles(*batch);
+        std::vector<std::string> outputFiles;
+        try {
+            outputFiles = PL0::getBatchOutputPaths(srcFiles, outputFile);
+        } catch (const std::runtime_error& e) {
+            PL0::Reporter::error(e.what());
+            return 1;
+        }
+        size_t threadCount = static_cast<size_t>(*(argParser.get<int>("j")));
+        size_t failedCount = PL0::runBatch(srcFiles, threadCount, [&](size_t i) {
+            recognizeIdent(srcFiles[i], outputFiles[i]);
+        });
+        return failedCount == 0 ? 0 : 1;
+    }
+
     std::string srcFile = *(argParser.get<std::string>("f"));
     std::cout << "Source file: " << srcFile << std::endl;
-
-    std::string outputFile = *(argParser.get<std::string>("o"));
     std::cout << "Output file: " << outputFile << std::endl;
 
     recognizeIdent(srcFile, outputFile);
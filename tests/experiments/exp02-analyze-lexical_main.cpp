@@ -1,24 +1,26 @@
 #include <algorithm>
-#include <format>
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "PL0.hpp"
 
-void analyzeLexical(const std::string& srcFile, const std::string& outputFile)
+void analyzeLexical(const std::string& srcFile, const std::string& outputFile,
+                    const PL0::Lexer& lexer)
 {
-    PL0::Lexer lexer;
-    std::vector<PL0::Token> tokens = lexer.tokenize(srcFile);
+    PL0::TokenList tokens = lexer.tokenize(srcFile);
 
-    std::ofstream output(outputFile);
-    if (!output.is_open()) {
-        throw std::runtime_error(std::format("Failed to open file: {}", outputFile));
-    }
+    /**
+     * @note Each line is written into the buffer of the output file piece by piece, so dumping
+     *      the tokens costs no formatting and no flush per line.
+     */
+    PL0::OutputFile output(outputFile);
     for (const PL0::Token& token : tokens) {
-        std::string code = PL0::Lexer::encode(token);
-        output << std::format("({}, {})", code, token.value) << std::endl;
+        output.write('(');
+        output.write(PL0::Lexer::encode(token));
+        output.write(", ");
+        output.write(token.value);
+        output.write(")\n");
     }
     output.close();
 }
@@ -27,14 +29,40 @@ int main(int argc, char* argv[])
 {
     PL0::ArgParser argParser;
     argParser.addOption("f", "The source file to be compiled", "string");
-    argParser.addOption("o", "The output file", "string", "a.out");
+    argParser.addOption("c", "The directory of the token cache (disabled by default)", "string");
+    argParser.addOption("o", "The output file (the output directory in batch mode)", "string",
+                        "a.out");
+    argParser.addOption("b", "A directory or a manifest file of source files to compile in batch",
+                        "string");
+    argParser.addOption("j", "The number of threads in batch mode (0 for one per hardware thread)",
+                        "int", "0");
     argParser.parse(argc, argv);
 
+    std::string outputFile = *(argParser.get<std::string>("o"));
+
+    // The lexer only holds its settings, so it is shared by all the files of a batch.
+    PL0::Lexer lexer;
+    lexer.setCacheDirectory(argParser.get<std::string>("c").value_or(""));
+
+    if (auto batch = argParser.get<std::string>("b")) {
+        std::vector<std::string> srcFiles = PL0::listBatchFiles(*batch);
+        std::vector<std::string> outputFiles;
+        try {
+            outputFiles = PL0::getBatchOutputPaths(srcFiles, outputFile);
+        } catch (const std::runtime_error& e) {
+            PL0::Reporter::error(e.what());
+            return 1;
+        }
+        size_t threadCount = static_cast<size_t>(*(argParser.get<int>("j")));
+        size_t failedCount = PL0::runBatch(srcFiles, threadCount, [&](size_t i) {
+            analyzeLexical(srcFiles[i], outputFiles[i], lexer);
+        });
+        return failedCount == 0 ? 0 : 1;
+    }
+
     std::string srcFile = *(argParser.get<std::string>("f"));
     std::cout << "Source file: " << srcFile << std::endl;
-
-    std::string outputFile = *(argParser.get<std::string>("o"));
     std::cout << "Output file: " << outputFile << std::endl;
 
-    analyzeLexical(srcFile, outputFile);
+    analyzeLexical(srcFile, outputFile, lexer);
 }
\ No newline at end of file
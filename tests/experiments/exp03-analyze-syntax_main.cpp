@@ -2,6 +2,9 @@
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -9,24 +12,93 @@
 
 #include <functional>
 
-void analyzeSyntax(const std::string& srcFile)
+void analyzeSyntax(const std::string& srcFile, const PL0::Lexer& lexer,
+                   const PL0::Parser& parser, bool printTree)
 {
-    PL0::Lexer lexer;
-    std::vector<PL0::Token> tokens = lexer.tokenize(srcFile);
+    PL0::TokenList tokens = lexer.tokenize(srcFile);
 
-    // PL0::RecursiveDescentParser parser;
-    PL0::LL1Parser parser;
-    parser.parse(tokens);
+    if (!printTree) {
+        parser.parse(tokens);
+        return;
+    }
+    PL0::CompilationUnit unit;
+    parser.parse(tokens, unit);
+    if (unit.getRoot() != PL0::NO_NODE) {
+        std::ostringstream tree;
+        unit.print(tree);
+        std::string text = tree.str();
+        text.pop_back();  // The last newline, which the reporter adds back
+        PL0::Reporter::info("Syntax tree:\n" + text);
+    }
 }
 
 int main(int argc, char* argv[])
 {
     PL0::ArgParser argParser;
     argParser.addOption("f", "The source file to be compiled", "string");
+    argParser.addOption("c", "The directory of the token cache (disabled by default)", "string");
+    argParser.addOption("b", "A directory or a manifest file of source files to compile in batch",
+                        "string");
+    argParser.addOption("j", "The number of threads in batch mode (0 for one per hardware thread)",
+                        "int", "0");
+    argParser.addOption("g",
+                        "A grammar file to build the parser from (the built-in grammar by default)",
+                        "string");
+    argParser.addOption("p",
+                        "The parser: ll1 for expressions (by default), or rd for whole programs",
+                        "string", "ll1");
+    argParser.addOption("e", "The engine of the built-in grammar: pratt (by default) or table",
+                        "string");
+    argParser.addOption("t", "Whether to print the syntax tree", "bool", "false");
     argParser.parse(argc, argv);
 
+    bool printTree = *(argParser.get<bool>("t"));
+
+    std::optional<std::string> engineOption = argParser.get<std::string>("e");
+    std::string engineName = engineOption.value_or("pratt");
+    if (engineName != "pratt" && engineName != "table") {
+        PL0::Reporter::error("Unknown engine: " + engineName);
+        return 1;
+    }
+    PL0::ExpressionEngine engine =
+        engineName == "pratt" ? PL0::ExpressionEngine::Pratt : PL0::ExpressionEngine::Table;
+
+    // The tables of the parser are built once, and shared by all the files of a batch.
+    // The tables of a grammar file are cached in "<grammar file>.tables" for the next run.
+    std::optional<std::string> grammarFile = argParser.get<std::string>("g");
+    std::string parserName = *(argParser.get<std::string>("p"));
+    std::unique_ptr<PL0::Parser> parser;
+    if (parserName == "rd") {
+        // The whole-program parser has its own grammar, so neither option applies to it.
+        if (grammarFile || engineOption) {
+            PL0::Reporter::error("-g and -e only apply to the ll1 parser.");
+            return 1;
+        }
+        parser = std::make_unique<PL0::RecursiveDescentParser>();
+    } else if (parserName == "ll1") {
+        parser = grammarFile ? std::make_unique<PL0::LL1Parser>(
+                                   PL0::ParseTables::load(*grammarFile))
+                             : std::make_unique<PL0::LL1Parser>(engine);
+    } else {
+        PL0::Reporter::error("Unknown parser: " + parserName);
+        return 1;
+    }
+
+    // The lexer only holds its settings, so it is shared by all the files of a batch as well.
+    PL0::Lexer lexer;
+    lexer.setCacheDirectory(argParser.get<std::string>("c").value_or(""));
+
+    if (auto batch = argParser.get<std::string>("b")) {
+        std::vector<std::string> srcFiles = PL0::listBatchFiles(*batch);
+        size_t threadCount = static_cast<size_t>(*(argParser.get<int>("j")));
+        size_t failedCount = PL0::runBatch(srcFiles, threadCount, [&](size_t i) {
+            analyzeSyntax(srcFiles[i], lexer, *parser, printTree);
+        });
+        return failedCount == 0 ? 0 : 1;
+    }
+
     std::string srcFile = *(argParser.get<std::string>("f"));
     std::cout << "Source file: " << srcFile << std::endl;
 
-    analyzeSyntax(srcFile);
+    analyzeSyntax(srcFile, lexer, *parser, printTree);
 }
\ No newline at end of file
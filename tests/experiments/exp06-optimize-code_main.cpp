@@ -16,6 +16,9 @@ void optimizeCode(const std::string& srcFile, const std::string& outputFile)
         while (std::getline(lineStream, part, ',')) {
             quadParts.push_back(part);
         }
+        if (quadParts.size() != 4) {
+            throw std::runtime_error(std::format("Invalid quadruple: {}", line));
+        }
 
         PL0::Quadruple quad;
         quad.op = quadParts[0];
@@ -45,13 +48,38 @@ int main(int argc, char* argv[])
 {
     PL0::ArgParser argParser;
     argParser.addOption("f", "The source file to be compiled", "string");
-    argParser.addOption("o", "The output file", "string");
+    argParser.addOption("o", "The output file (the output directory in batch mode)", "string");
+    argParser.addOption("b", "A directory or a manifest file of source files to compile in batch",
+                        "string");
+    argParser.addOption("j", "The number of threads in batch mode (0 for one per hardware thread)",
+                        "int", "0");
     argParser.parse(argc, argv);
 
+    std::optional<std::string> output = argParser.get<std::string>("o");
+    if (!output) {
+        PL0::Reporter::error("No output file (the output directory in batch mode) is given by -o.");
+        return 1;
+    }
+    std::string outputFile = *output;
+
+    if (auto batch = argParser.get<std::string>("b")) {
+        std::vector<std::string> srcFiles = PL0::listBatchFiles(*batch);
+        std::vector<std::string> outputFiles;
+        try {
+            outputFiles = PL0::getBatchOutputPaths(srcFiles, outputFile);
+        } catch (const std::runtime_error& e) {
+            PL0::Reporter::error(e.what());
+            return 1;
+        }
+        size_t threadCount = static_cast<size_t>(*(argParser.get<int>("j")));
+        size_t failedCount = PL0::runBatch(srcFiles, threadCount, [&](size_t i) {
+            optimizeCode(srcFiles[i], outputFiles[i]);
+        });
+        return failedCount == 0 ? 0 : 1;
+    }
+
     std::string srcFile = *(argParser.get<std::string>("f"));
     std::cout << "Source file: " << srcFile << std::endl;
-
-    std::string outputFile = *(argParser.get<std::string>("o"));
     std::cout << "Output file: " << outputFile << std::endl;
 
     optimizeCode(srcFile, outputFile);
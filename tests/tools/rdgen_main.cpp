@@ -0,0 +1,54 @@
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "PL0.hpp"
+
+/**
+ * @brief Write a file unless it already has the content, so the code including a generated header
+ *      is not rebuilt for nothing.
+ */
+void writeIfChanged(const std::string& path, const std::string& content)
+{
+    if (std::ifstream input(path, std::ios::binary); input.is_open()) {
+        std::ostringstream current;
+        current << input.rdbuf();
+        if (current.str() == content) {
+            return;
+        }
+    }
+    std::ofstream output(path, std::ios::binary);
+    if (!output.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file: {}", path));
+    }
+    output << content;
+}
+
+int main(int argc, char* argv[])
+{
+    PL0::ArgParser argParser;
+    argParser.addOption("g", "The grammar file to generate the parser from", "string");
+    argParser.addOption("o", "The header to generate (the standard output by default)", "string");
+    argParser.addOption("n", "The name of the parser class", "string", "GeneratedParser");
+    argParser.parse(argc, argv);
+
+    std::string grammarFile = *(argParser.get<std::string>("g"));
+    std::string className = *(argParser.get<std::string>("n"));
+
+    try {
+        PL0::ParserGenerator generator(PL0::ParseTables::build(PL0::Grammar::load(grammarFile)));
+        std::string code = generator.generate(
+            className, std::filesystem::path(grammarFile).filename().string());
+        if (auto outputFile = argParser.get<std::string>("o")) {
+            writeIfChanged(*outputFile, code);
+        } else {
+            std::cout << code;
+        }
+    } catch (const std::runtime_error& e) {
+        PL0::Reporter::error(e.what());
+        return 1;
+    }
+}